@@ -0,0 +1,133 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include "json.hpp"
+
+struct point {
+	double x, y;
+};
+
+template<>
+struct json_fields<point> {
+	static constexpr auto members = std::make_tuple(json_field("x", &point::x), json_field("y", &point::y));
+};
+
+struct record {
+	int64_t id;
+	double value;
+	std::string name;
+	bool active;
+	std::optional<int64_t> parent;
+	std::vector<std::string> tags;
+	point position;
+};
+
+template<>
+struct json_fields<record> {
+	static constexpr auto members = std::make_tuple(
+		json_field("id", &record::id),
+		json_field("value", &record::value),
+		json_field("name", &record::name),
+		json_field("active", &record::active),
+		json_field("parent", &record::parent),
+		json_field("tags", &record::tags),
+		json_field("position", &record::position)
+	);
+};
+
+static std::string generateDocument(const size_t records) {
+	std::string txt = "[\n";
+	for (size_t i = 0; i < records; i++) {
+		txt += "\t{\n";
+		txt += "\t\t\"id\": " + std::to_string(i) + ",\n";
+		txt += "\t\t\"value\": " + std::to_string(i * 0.731) + ",\n";
+		txt += "\t\t\"name\": \"record number " + std::to_string(i) + "\",\n";
+		txt += "\t\t\"active\": " + std::string(i % 3 ? "true" : "false") + ",\n";
+		txt += "\t\t\"parent\": null,\n";
+		txt += "\t\t\"tags\": [ \"alpha\", \"beta\", \"gamma\" ],\n";
+		txt += "\t\t\"position\": { \"x\": -1.5, \"y\": 2.25e3 }\n";
+		txt += i + 1 == records ? "\t}\n" : "\t},\n";
+	}
+	return txt + "]\n";
+}
+
+template<typename F>
+static void benchmark(const char* name, const std::string& txt, const int iterations, F&& f) {
+	size_t checksum = 0;
+	const auto begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		checksum += f(txt);
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const double seconds = std::chrono::duration<double>(end - begin).count();
+	const double megabytes = (double)txt.length() * iterations / (1024 * 1024);
+	std::cout << name << ": " << megabytes / seconds << " MB/s (" << checksum << ")" << std::endl;
+}
+
+int main() {
+	const std::string txt = generateDocument(100000);
+	std::cout << "document size: " << txt.length() / 1024 << " KiB" << std::endl;
+
+	benchmark("json::parse               ", txt, 10, [](const std::string& txt) {
+		return json::parse(txt).size();
+	});
+	benchmark("json::parse (json_keys)   ", txt, 10, [](const std::string& txt) {
+		return json::parse(txt, json_keys::global()).size();
+	});
+	const json_projection ids{ "/*/id" };
+	benchmark("json::parse (projection)  ", txt, 10, [&](const std::string& txt) {
+		return json::parse(txt, ids).size();
+	});
+	benchmark("json::parse_fast          ", txt, 10, [](const std::string& txt) {
+		return json::parse_fast(txt).size();
+	});
+	benchmark("json_arena::parse         ", txt, 10, [](const std::string& txt) {
+		json_arena arena;
+		return arena.parse(txt).size();
+	});
+	benchmark("json_arena::parse_fast    ", txt, 10, [](const std::string& txt) {
+		json_arena arena;
+		return arena.parse_fast(txt).size();
+	});
+	benchmark("json::parse_parallel      ", txt, 10, [](const std::string& txt) {
+		return json::parse_parallel(txt).size();
+	});
+	benchmark("json_arena::parse_parallel", txt, 10, [](const std::string& txt) {
+		json_arena arena;
+		return arena.parse_parallel(txt).size();
+	});
+	benchmark("json_tape::parse          ", txt, 10, [](const std::string& txt) {
+		return json_tape::parse(txt).size();
+	});
+	benchmark("json::parse_events        ", txt, 10, [](const std::string& txt) {
+		struct {
+			size_t objects = 0;
+			void on_object_begin() { objects++; }
+		} counter;
+		json::parse_events(txt, counter);
+		return counter.objects;
+	});
+	benchmark("json::parse_as<records>   ", txt, 10, [](const std::string& txt) {
+		return json::parse_as<std::vector<record>>(txt).size();
+	});
+	benchmark("json_cursor (1 field)     ", txt, 10, [](const std::string& txt) {
+		return (size_t)(Number)json_cursor(txt)[99999ul]["id"];
+	});
+
+	const json document = json::parse(txt);
+	benchmark("json::to_string (ostream) ", txt, 10, [&](const std::string&) {
+		std::ostringstream out;
+		document.to_string(out);
+		return out.str().length();
+	});
+	benchmark("json::dump                ", txt, 10, [&](const std::string&) {
+		return document.dump().length();
+	});
+
+	const std::vector<record> records = json::parse_as<std::vector<record>>(txt);
+	benchmark("json::write<records>      ", txt, 10, [&](const std::string&) {
+		return json::write(records).length();
+	});
+}
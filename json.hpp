@@ -1,563 +1,4330 @@
-#pragma once
-
-#include <string>
-#include <vector>
-#include <unordered_map>
-#include <ostream>
-#include <stdexcept>
-#include <string.h>
-
-#if defined(__clang__) && __clang_major__ >= 5 || defined(__GNUC__) && __GNUC__ >= 9 || defined(_MSC_VER) && _MSC_VER >= 1920
-#  undef  ENUM_NAMES_SUPPORT
-#  define ENUM_NAMES_SUPPORT 1
-#endif
-
-template <typename E, E V>
-constexpr auto enum_to_string() noexcept {
-	static_assert(std::is_enum<E>::value, "Parameter has to be an enum");
-
-	constexpr auto extractName = [](const std::string_view& s) {
-		auto it = s.end(); 
-		while (*it != ':') it--;
-		return std::string_view(++it, s.end());
-	};
-
-#if defined(ENUM_NAMES_SUPPORT) && ENUM_NAMES_SUPPORT
-#  if defined(__clang__) || defined(__GNUC__)
-	constexpr auto name = extractName({__PRETTY_FUNCTION__, sizeof(__PRETTY_FUNCTION__) - 2});
-#  elif defined(_MSC_VER)
-	constexpr auto name = extractName({__FUNCSIG__, sizeof(__FUNCSIG__) - 17});
-#  endif
-	return name;
-#else
-	return std::string_view{ std::to_string_view((int)V) };
-#endif
-}
-
-template<typename T, typename... Ts>
-concept isAnyOf = (std::same_as<T, Ts> || ...);
-
-template<typename E, E NULL_TYPE, typename... Ts>
-class smartUnion {
-	static_assert(std::is_enum<E>::value, "Must be an enum type");
-
-private:
-	uint64_t data;
-
-	template <typename T>
-	static constexpr size_t find_index() {
-		constexpr bool matches[sizeof...(Ts)]{
-			std::is_same<T, Ts>::value...
-		};
-		size_t index = -1;
-		for (size_t i = 0; i < sizeof...(Ts); i++) {
-			if (matches[i]) {
-				if (index != -1) {
-					return -2;
-				}
-				index = i;
-			}
-		}
-		return index;
-	}
-
-	template<typename T>
-	static constexpr E find_enum_type() {
-		const constexpr size_t idx = find_index<T>();
-		static_assert(idx != -1, "use of unknown type");
-		static_assert(idx != -2, "use of ambiguous type");
-		return (E) (idx + 1);
-	}
-
-	template<typename ENUM, typename T>
-	static constexpr std::string_view type_to_string() {
-		return enum_to_string<ENUM, find_enum_type<T>()>();
-	};
-
-	std::string enum_type_to_string(E v) const noexcept {
-		constexpr std::string_view names[]{
-			type_to_string<E, Ts>()...
-		};
-		const size_t idx = ((size_t)v) - 1;
-		return v == NULL_TYPE ? "null" : idx < sizeof...(Ts) ? std::string(names[idx]) : "unknown";
-	}
-
-	static constexpr bool using_pointer(E t) {
-		constexpr bool use_pointer[sizeof...(Ts)]{
-			(sizeof(Ts) > sizeof(void*))...
-		};
-		return t == NULL_TYPE ? false : use_pointer[((size_t)t) - 1];
-	}
-
-public:
-	E type;
-
-	smartUnion() : data{ 0 }, type{ NULL_TYPE } {}
-
-	template<typename T>
-	smartUnion(const T& t) requires isAnyOf<T, Ts...> {
-		type = find_enum_type<T>();
-		if constexpr (sizeof(T) > sizeof(void*)) {
-			data = (uint64_t) new T(t);
-		} else {
-			data = *(uint64_t*)&t;
-		}
-	}
-
-	template<typename T>
-	smartUnion(T&& t) requires isAnyOf<T, Ts...> {
-		type = find_enum_type<T>();
-		if constexpr (sizeof(T) > sizeof(void*)) {
-			data = (uint64_t) new T(std::move(t));
-		} else {
-			data = *(uint64_t*)&t;
-		}
-	}
-
-	smartUnion(smartUnion<E,  NULL_TYPE, Ts...>&& otherUnion) {
-		type = otherUnion.type;
-		data = otherUnion.data;
-		if (using_pointer(type)) {
-			otherUnion.type = NULL_TYPE;
-			otherUnion.data = 0;
-		}
-	}
-
-	~smartUnion() {
-		if (using_pointer(type)) {
-			delete (char*)data;
-		}
-	}
-
-	template<typename T>
-	smartUnion<E, NULL_TYPE, Ts...>& operator=(const T& t) requires isAnyOf<T, Ts...> {
-		E newType = find_enum_type<T>();
-		if constexpr (sizeof(T) > sizeof(void*)) {
-			if (newType == type) {
-				((T*)data)->operator=(t);
-			} else {
-				if (using_pointer(type))
-					delete (char*) data;
-				data = (uint64_t) new T(t);
-			}
-		} else {
-			if (using_pointer(type))
-					delete (char*) data;
-			data = *(uint64_t*)&t;
-		}
-		type = newType;
-		return *this;
-	}
-
-	template<typename T>
-	smartUnion<E, NULL_TYPE, Ts...>& operator=(T&& t) requires isAnyOf<T, Ts...> {
-		E newType = find_enum_type<T>();
-		if constexpr (sizeof(T) > sizeof(void*)) {
-			if (newType == type) {
-				((T*)data)->operator=(t);
-			} else {
-				if (using_pointer(type))
-					delete (char*) data;
-				data = (uint64_t) new T(std::move(t));
-			}
-		} else {
-			if (using_pointer(type))
-				delete (char*) data;
-			data = *(uint64_t*)&t;
-		}
-		type = newType;
-		return *this;
-	}
-		
-	smartUnion<E, NULL_TYPE, Ts...>& operator=(smartUnion<E,  NULL_TYPE, Ts...>&& otherUnion) {
-		if (using_pointer(type))
-			delete (char*) data;
-		data = otherUnion.data;
-		type = otherUnion.type;
-		otherUnion.type = NULL_TYPE;
-		otherUnion.data = 0;
-		return *this;
-	}
-
-	template<typename T>
-	const T& get() const requires isAnyOf<T, Ts...> {
-		E tType = find_enum_type<T>();
-		if (tType != type) {
-			std::string message("Tried to access ");
-			message += enum_type_to_string(tType);
-			message += " but dynamic type was ";
-			message += enum_type_to_string(type);
-			throw std::invalid_argument(message);
-		}
-		if constexpr (sizeof(T) > sizeof(void*)) {
-			return *(T*)data;
-		} else {
-			return *(T*)&data;
-		}
-	}
-
-	template<typename T>
-	T& get() requires isAnyOf<T, Ts...> {
-		E tType = find_enum_type<T>();
-		if (tType!= type) {
-			std::string message("Tried to access ");
-			message += enum_type_to_string(tType);
-			message += " but dynamic type was ";
-			message += enum_type_to_string(type);
-			throw std::invalid_argument(message);
-		}
-		if constexpr (sizeof(T) > sizeof(void*)) {
-			return *(T*)data;
-		} else {
-			return *(T*)&data;
-		}
-	}
-
-	template<typename T>
-	smartUnion copy() const requires isAnyOf<T, Ts...> {
-		E tType = find_enum_type<T>();
-		if (tType != type) {
-			std::string message("Tried to access ");
-			message += enum_type_to_string(tType);
-			message += " but dynamic type was ";
-			message += enum_type_to_string(type);
-			throw std::invalid_argument(message);
-		}
-		return smartUnion(std::move(T(get<T>())));
-	}
-};
-
-class json;
-
-typedef bool Boolean;
-typedef double Number;
-typedef std::string String;
-typedef std::vector<json> Array;
-typedef std::unordered_map<std::string, json> Object;
-
-template<class T>
-concept json_data_type = isAnyOf<T, Boolean, Number, String, Array, Object>;
-
-class json {
-public:
-	enum class json_type : uint8_t {
-		null,
-		boolean,
-		number,
-		string,
-		array,
-		object
-	};
-
-	static std::string typeToString(json_type type) {
-		switch (type) {
-		using enum json_type;
-		case null:	return "null";
-		case boolean:	return "boolean";
-		case number:	return "number";
-		case string:	return "string";
-		case array:		return "array";
-		case object:	return "object";
-		default: throw std::runtime_error("Invalid json type");
-		}
-	}
-
-
-private:
-	typedef smartUnion<json_type, json_type::null, Boolean, Number, String, Array, Object> json_data;
-
-	json_data data;
-
-public:
-
-	//----------------------[ constructors ]---------------------//
-	
-	json() = default;
-
-	template<json_data_type T>
-	json(const T& newData) : data(newData) {}
-
-	template<json_data_type T>
-	json(T&& newData) : data(std::move(newData)) {}
-
-	
-	json(const json& otherJSON) : data(copy_json_data(otherJSON.data)) {}
-
-	json(json&& otherJSON) : data(std::move(otherJSON.data)) {}
-
-	static json_data copy_json_data(const json_data& data) {
-		switch (data.type) {
-		using enum json_type;
-		case boolean:	return data.copy<Boolean>();
-		case number:	return data.copy<Number>();
-		case string:	return data.copy<String>();
-		case array:		return data.copy<Array>();
-		case object:	return data.copy<Object>();
-		default: return json_data();
-		}
-	}
-
-	//----------------------[ parsing ]---------------------//
-
-	static json parse(const std::string& txt) {
-		if (txt.length() < 2)
-			throw std::runtime_error("Invalid json (empty string)");
-
-		size_t index = 0;
-		if (txt[0] != '{' && txt[0] != '[')
-			skipSpaces(txt, index);
-
-		if (txt[index] == '{') {
-			return json::parseObject(txt, index);
-		} else if (txt[index] == '[') {
-			return json::parseArray(txt, index);
-		} else {
-			throw std::runtime_error("Invalid json");
-		}
-	}
-
-private:
-	inline static void skipSpaces(const std::string& txt, size_t& index) {
-		while (++index < txt.length()) {
-			if (!std::isspace(txt[index])) {
-				break;
-			}
-		}
-	}
-
-	typedef json (*parser)(const std::string& txt, size_t& index);
-
-	static const parser getParser(const char begin) {
-		switch (begin) {
-			using namespace std::string_literals;
-			case '{':			return &json::parseObject;
-			case '[':			return &json::parseArray;
-			case '\"':			return &json::parseString;
-			case 't':
-			case 'f':			return &json::parseBoolean;
-			case '0' ... '9':	return &json::parseNumber;
-			case 'n':			return &json::parseNull;
-			default: throw std::runtime_error("Invalid symbole begin: "s + begin);
-		}
-	}
-
-	static json parseNull(const std::string& txt, size_t& index) {
-		if (txt.length() > index + 3 && !strncmp(&txt[index], "null", 4)) {
-			index += 3;
-			return json();
-		} else {
-			throw parsingError(txt, index);
-		}
-	}
-
-	static json parseBoolean(const std::string& txt, size_t& index)  {
-		if (index < txt.length()) {
-			if (strncmp(&txt[index], "false", 5) == 0) {
-				index += 4;
-				return json(false);
-			} else if (strncmp(&txt[index], "true", 4) == 0) {
-				index += 3;
-				return json(true);
-			}
-		}
-		throw parsingError(txt, index);
-	}
-	
-	static json parseNumber(const std::string& txt, size_t& index) {
-		std::size_t parsedChars = 0;
-		double data = std::stod(txt.substr(index), &parsedChars);
-		index += parsedChars - 1;
-		return json(data);
-	}
-
-	static json parseString(const std::string& txt, size_t& index) {
-		std::string data;
-		while (txt[++index] != '\"') {
-			data += txt[index];
-			if (index + 2 >= txt.length()) {
-				throw parsingError(txt, index);
-			}
-		}
-		return json(std::move(data));
-	}
-
-	static json parseArray(const std::string& txt, size_t& index) {
-		skipSpaces(txt, index);
-		const parser f = getParser(txt[index]);
-		index--;
-		Array data;
-		do {
-			skipSpaces(txt, index);
-			data.push_back(f(txt, index));
-			skipSpaces(txt, index);
-		} while (txt[index] == ',' && index < txt.length());
-
-		return json(std::move(data));
-	}
-
-	static json parseObject(const std::string& txt, size_t& index) {
-		Object data;
-		do {
-			skipSpaces(txt, index);
-
-			if(txt[index] == '}')
-				return json(data);
-
-			std::string name;
-			for (++index; index < txt.length() && txt[index] != '\"'; index++) {
-				name += txt[index];
-			}
-
-			skipSpaces(txt, index);
-			skipSpaces(txt, index);
-
-			data.insert({ name, getParser(txt[index])(txt, index) });
-
-			skipSpaces(txt, index);
-
-		} while (txt[index] == ',' && index < txt.length());
-
-		return json(std::move(data));
-	}
-
-	static const std::runtime_error parsingError(const std::string& txt, const size_t index) {
-		using std::operator""s;
-		return std::runtime_error(
-			"Invalid symbole '"s + txt[index] + "' at index "s +
-			std::to_string(index) + '\''
-		);
-	}
-
-public:
-	//----------------------[ accesors ]---------------------//
-
-	const json& operator[](const size_t index) const {
-		return data.get<Array>()[index];
-	}
-
-	json& operator[](const size_t index) {
-		return data.get<Array>()[index];
-	}
-
-
-	const json& operator[](const char* s) const { return data.get<Object>().at(s); }
-	const json& operator[](const std::string& s) const { return data.get<Object>().at(s); }
-
-	json& operator[](const char* s) { return data.get<Object>()[s]; }
-	json& operator[](const std::string& s) { return data.get<Object>()[s]; }
-
-	json_type getType() const { return data.type; };
-
-	size_t size() const {
-		switch (data.type) {
-			using enum json_type;
-			case array:		return data.get<Array>().size();
-			case object:	return data.get<Object>().size();
-			default: data.get<Array>(); // throws access error
-		}
-		return 0;
-	}
-
-	size_t length() const {
-		return data.get<String>().length();
-	}
-
-	//----------------------[ to_string ]---------------------//
-	
-	friend std::ostream & operator<<(std::ostream&, const json&);
-
-	void to_string(std::ostream& out, int indent = -1) const {
-		static const constexpr char tab = '\t';
-		using enum json_type;
-
-		if (data.type == null) {
-			out << "null";
-		} else if (data.type == boolean) {
-			out << (data.get<Boolean>() ? "true" : "false");
-		} else if (data.type == number) {
-			out <<  std::to_string(data.get<Number>());
-		} else if (data.type == string) {
-			out <<  "\"" << data.get<String>() << "\"";
-		} else {
-			const std::string indentTabs = (indent < 0 ? "" : std::string(++indent, tab));
-			const std::string lineBreak = (indent < 0 ? "" : "\n");
-			
-			if (data.type == array) {
-				out  << "[" << lineBreak;
-				auto it = data.get<Array>().begin();
-				const auto end = data.get<Array>().end();
-				while (it != end) {
-					out << indentTabs;
-					it->to_string(out, indent);
-					if (++it == end) {
-						out << lineBreak;
-						break;
-					} else out << "," << lineBreak;
-				}
-				out << (indent < 0 ? "" : std::string(--indent, tab)) << "]";
-			} 
-			else if (data.type == object) {
-				out << "{" << lineBreak;
-				auto it = data.get<Object>().begin();
-				const auto end = data.get<Object>().end();
-				while (it != end) {
-					out << indentTabs << "\"" << it->first << "\": ";
-					it->second.to_string(out, indent);
-					if (++it == end) {
-						out << lineBreak;
-						break;
-					}
-					else out << "," << lineBreak;
-				}
-				out << (indent < 0 ? "" : std::string(--indent, tab)) << "}";
-			}
-		}
-	}
-
-
-	//----------------------[ assignemt ]---------------------//
-
-	template<json_data_type T>
-	json& operator=(const T& t) {
-		data = t;
-		return *this;
-	}
-
-	template<json_data_type T>
-	json& operator=(T&& t) {
-		data = std::move(t);
-		return *this;
-	}
-
-	json& operator=(const json& otherJSON) {
-		data = std::move(copy_json_data(otherJSON.data));
-		return *this;
-	}
-
-	json& operator=(json&& otherJSON) {
-		data = std::move(otherJSON.data);
-		return *this;
-	}
-	
-	//----------------------[ casts ]---------------------//
-	
-	template<json_data_type T>
-	operator const T() const {
-		return data.get<T>();
-	}
-
-	template<json_data_type T>
-	operator const T&() const {
-		return data.get<T>();
-	}
-
-	template<json_data_type T>
-	operator T&() {
-		return data.get<T>();
-	}
-};
-
-std::ostream& operator<<(std::ostream& os, const json& json) {
-	json.to_string(os, 0);
-	return os;
-}
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <memory>
+#include <new>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <mutex>
+#include <memory_resource>
+#include <ostream>
+#include <stdexcept>
+#include <charconv>
+#include <string.h>
+#include <bit>
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <concepts>
+#include <exception>
+#include <thread>
+#include <atomic>
+#include <system_error>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <iterator>
+#include <tuple>
+#include <optional>
+#include <array>
+
+#if defined(__clang__) && __clang_major__ >= 5 || defined(__GNUC__) && __GNUC__ >= 9 || defined(_MSC_VER) && _MSC_VER >= 1920
+#  undef  ENUM_NAMES_SUPPORT
+#  define ENUM_NAMES_SUPPORT 1
+#endif
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define JSON_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#  include <emmintrin.h>
+#  define JSON_SIMD_SSE2 1
+#endif
+#if defined(__PCLMUL__)
+#  include <wmmintrin.h>
+#  define JSON_SIMD_CLMUL 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  define JSON_MMAP 1
+#else
+#  include <fstream>
+#  include <sstream>
+#endif
+
+template <typename E, E V>
+constexpr auto enum_to_string() noexcept {
+	static_assert(std::is_enum<E>::value, "Parameter has to be an enum");
+
+	constexpr auto extractName = [](const std::string_view& s) {
+		auto it = s.end(); 
+		while (*it != ':') it--;
+		return std::string_view(++it, s.end());
+	};
+
+#if defined(ENUM_NAMES_SUPPORT) && ENUM_NAMES_SUPPORT
+#  if defined(__clang__) || defined(__GNUC__)
+	constexpr auto name = extractName({__PRETTY_FUNCTION__, sizeof(__PRETTY_FUNCTION__) - 2});
+#  elif defined(_MSC_VER)
+	constexpr auto name = extractName({__FUNCSIG__, sizeof(__FUNCSIG__) - 17});
+#  endif
+	return name;
+#else
+	return std::string_view{ std::to_string_view((int)V) };
+#endif
+}
+
+template<typename T, typename... Ts>
+concept isAnyOf = (std::same_as<T, Ts> || ...);
+
+// Tagged union over Ts, indexed by the enum E (NULL_TYPE is the empty state).
+// Values of up to INLINE_SIZE bytes are stored in place, larger ones are boxed.
+template<typename E, E NULL_TYPE, size_t INLINE_SIZE, typename... Ts>
+class smartUnion {
+	static_assert(std::is_enum<E>::value, "Must be an enum type");
+
+private:
+	alignas(void*) alignas(Ts...) unsigned char data[INLINE_SIZE < sizeof(void*) ? sizeof(void*) : INLINE_SIZE];
+
+	template <typename T>
+	static constexpr size_t find_index() {
+		constexpr bool matches[sizeof...(Ts)]{
+			std::is_same<T, Ts>::value...
+		};
+		size_t index = -1;
+		for (size_t i = 0; i < sizeof...(Ts); i++) {
+			if (matches[i]) {
+				if (index != -1) {
+					return -2;
+				}
+				index = i;
+			}
+		}
+		return index;
+	}
+
+	template<typename T>
+	static constexpr E find_enum_type() {
+		const constexpr size_t idx = find_index<T>();
+		static_assert(idx != -1, "use of unknown type");
+		static_assert(idx != -2, "use of ambiguous type");
+		return (E) (idx + 1);
+	}
+
+	template<typename ENUM, typename T>
+	static constexpr std::string_view type_to_string() {
+		return enum_to_string<ENUM, find_enum_type<T>()>();
+	};
+
+	std::string enum_type_to_string(E v) const noexcept {
+		constexpr std::string_view names[]{
+			type_to_string<E, Ts>()...
+		};
+		const size_t idx = ((size_t)v) - 1;
+		return v == NULL_TYPE ? "null" : idx < sizeof...(Ts) ? std::string(names[idx]) : "unknown";
+	}
+
+	template<typename T>
+	static constexpr bool is_boxed() {
+		// moving has to stay noexcept, so types that could throw on it are boxed as well
+		return sizeof(T) > sizeof(data) || !std::is_nothrow_move_constructible_v<T>;
+	}
+
+	// Boxes are allocated with the allocator of the value they hold,
+	// so allocator aware values live in the same memory resource as their contents.
+	template<typename T>
+	static auto box_allocator(const T& t) {
+		if constexpr (requires { t.get_allocator(); }) {
+			using traits = std::allocator_traits<decltype(t.get_allocator())>;
+			return typename traits::template rebind_alloc<T>(t.get_allocator());
+		} else {
+			return std::allocator<T>();
+		}
+	}
+
+	template<typename T>
+	T* pointer() const {
+		if constexpr (is_boxed<T>()) {
+			return *std::launder((T* const*)data);
+		} else {
+			return std::launder((T*)data);
+		}
+	}
+
+	template<typename T>
+	void store(const T& t) {
+		if constexpr (is_boxed<T>()) {
+			// a copy gets the same allocator as the copy constructor gives its contents
+			auto allocator = std::allocator_traits<decltype(box_allocator(t))>::
+				select_on_container_copy_construction(box_allocator(t));
+			T* const box = std::allocator_traits<decltype(allocator)>::allocate(allocator, 1);
+			new (box) T(t);
+			new (data) T*(box);
+		} else {
+			new (data) T(t);
+		}
+	}
+
+	template<typename T>
+	void store(T&& t) requires (!std::is_reference_v<T>) {
+		if constexpr (is_boxed<T>()) {
+			auto allocator = box_allocator(t);
+			T* const box = std::allocator_traits<decltype(allocator)>::allocate(allocator, 1);
+			new (box) T(std::move(t));
+			new (data) T*(box);
+		} else {
+			new (data) T(std::move(t));
+		}
+	}
+
+	// Calls f.template operator()<T>() with the dynamic type T, does nothing for NULL_TYPE.
+	template<typename F>
+	void visit(F&& f) const {
+		[&]<size_t... Is>(std::index_sequence<Is...>) {
+			((type == (E)(Is + 1) ? f.template operator()<Ts>() : void()), ...);
+		}(std::index_sequence_for<Ts...>());
+	}
+
+	void destroy() noexcept {
+		visit([this]<typename T>() {
+			T* const value = pointer<T>();
+			if constexpr (is_boxed<T>()) {
+				auto allocator = box_allocator(*value);
+				value->~T();
+				std::allocator_traits<decltype(allocator)>::deallocate(allocator, value, 1);
+			} else {
+				value->~T();
+			}
+		});
+		type = NULL_TYPE;
+	}
+
+	// Values that can be moved to another address by copying their bytes,
+	// types opt in by declaring a trivially_relocatable member type.
+	template<typename T>
+	static constexpr bool is_relocatable() {
+		return is_boxed<T>() || std::is_trivially_copyable_v<T> || requires { typename T::trivially_relocatable; };
+	}
+
+	// Takes over the value of otherUnion and leaves it empty, this has to be destroyed.
+	void take(smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>& otherUnion) noexcept {
+		if constexpr ((is_relocatable<Ts>() && ...)) {
+			memcpy(data, otherUnion.data, sizeof(data));
+		} else otherUnion.visit([&]<typename T>() {
+			if constexpr (is_boxed<T>()) {
+				new (data) T*(otherUnion.pointer<T>());
+			} else {
+				new (data) T(std::move(*otherUnion.pointer<T>()));
+				otherUnion.pointer<T>()->~T();
+			}
+		});
+		type = otherUnion.type;
+		otherUnion.type = NULL_TYPE;
+	}
+
+public:
+	E type;
+
+	// the bytes of empty unions are zeroed, so relocating them never copies indeterminate ones
+	smartUnion() : data{}, type{ NULL_TYPE } {}
+
+	template<typename T>
+	smartUnion(const T& t) requires isAnyOf<T, Ts...> : type{ find_enum_type<T>() } {
+		store(t);
+	}
+
+	template<typename T>
+	smartUnion(T&& t) requires isAnyOf<T, Ts...> : type{ find_enum_type<T>() } {
+		store(std::move(t));
+	}
+
+	smartUnion(smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>&& otherUnion) noexcept {
+		take(otherUnion);
+	}
+
+	~smartUnion() {
+		destroy();
+	}
+
+	template<typename T>
+	smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>& operator=(const T& t) requires isAnyOf<T, Ts...> {
+		if (find_enum_type<T>() == type) {
+			get<T>() = t;
+		} else {
+			// t might be owned by the current value, so copy it before destroying that
+			*this = smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>(t);
+		}
+		return *this;
+	}
+
+	template<typename T>
+	smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>& operator=(T&& t) requires isAnyOf<T, Ts...> {
+		if (find_enum_type<T>() == type) {
+			get<T>() = std::move(t);
+		} else {
+			*this = smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>(std::move(t));
+		}
+		return *this;
+	}
+		
+	smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>& operator=(smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...>&& otherUnion) noexcept {
+		// detach the other value first, it might be owned by the current one
+		smartUnion<E, NULL_TYPE, INLINE_SIZE, Ts...> detached(std::move(otherUnion));
+		destroy();
+		take(detached);
+		return *this;
+	}
+
+	template<typename T>
+	const T& get() const requires isAnyOf<T, Ts...> {
+		E tType = find_enum_type<T>();
+		if (tType != type) {
+			std::string message("Tried to access ");
+			message += enum_type_to_string(tType);
+			message += " but dynamic type was ";
+			message += enum_type_to_string(type);
+			throw std::invalid_argument(message);
+		}
+		return *pointer<T>();
+	}
+
+	template<typename T>
+	T& get() requires isAnyOf<T, Ts...> {
+		E tType = find_enum_type<T>();
+		if (tType!= type) {
+			std::string message("Tried to access ");
+			message += enum_type_to_string(tType);
+			message += " but dynamic type was ";
+			message += enum_type_to_string(type);
+			throw std::invalid_argument(message);
+		}
+		return *pointer<T>();
+	}
+
+	// Returns nullptr instead of throwing if the dynamic type is not T.
+	template<typename T>
+	const T* try_get() const noexcept requires isAnyOf<T, Ts...> {
+		return type == find_enum_type<T>() ? pointer<T>() : nullptr;
+	}
+
+	template<typename T>
+	T* try_get() noexcept requires isAnyOf<T, Ts...> {
+		return type == find_enum_type<T>() ? pointer<T>() : nullptr;
+	}
+
+	template<typename T>
+	smartUnion copy() const requires isAnyOf<T, Ts...> {
+		E tType = find_enum_type<T>();
+		if (tType != type) {
+			std::string message("Tried to access ");
+			message += enum_type_to_string(tType);
+			message += " but dynamic type was ";
+			message += enum_type_to_string(type);
+			throw std::invalid_argument(message);
+		}
+		return smartUnion(get<T>());
+	}
+};
+
+// Allocator aware string of 24 bytes: up to 15 characters are stored in place,
+// longer strings live in a single buffer allocated from the memory resource.
+// Strings made by shared() refer to immutable characters they do not own, and
+// copy them only once they are modified. The lowest two bits of the resource
+// pointer mark which of the three is in use.
+class json_string {
+public:
+	typedef std::pmr::polymorphic_allocator<char> allocator_type;
+	typedef char value_type;
+	typedef size_t size_type;
+	typedef char* iterator;
+	typedef const char* const_iterator;
+	// holds no pointers into itself, so json nodes may move it with memcpy
+	typedef std::true_type trivially_relocatable;
+
+private:
+	static constexpr size_t inlineCapacity = 15;
+	static constexpr uintptr_t heapFlag = 1;
+	static constexpr uintptr_t sharedFlag = 2;
+	static constexpr uintptr_t stateBits = heapFlag | sharedFlag;
+
+	// shared strings use it as well, with capacity equal to size
+	struct heap_buffer {
+		char* data;
+		uint32_t size;
+		uint32_t capacity;
+	};
+
+	uintptr_t resourceBits;
+	union {
+		heap_buffer heap;
+		// the last byte holds the unused capacity, so it doubles as the terminator of full strings
+		char buffer[inlineCapacity + 1];
+	};
+
+	bool isInline() const {
+		return (resourceBits & stateBits) == 0;
+	}
+
+	bool isShared() const {
+		return (resourceBits & sharedFlag) != 0;
+	}
+
+	std::pmr::memory_resource* resource() const {
+		return (std::pmr::memory_resource*)(resourceBits & ~stateBits);
+	}
+
+	void setSize(const size_t size) {
+		if (isInline()) {
+			buffer[inlineCapacity] = (char)(inlineCapacity - size);
+		} else {
+			heap.size = (uint32_t)size;
+		}
+		data()[size] = '\0';
+	}
+
+	void deallocate() {
+		if ((resourceBits & heapFlag) != 0)
+			resource()->deallocate(heap.data, heap.capacity + 1, 1);
+		resourceBits &= ~stateBits;
+	}
+
+	void reallocate(const size_t capacity) {
+		if (capacity >= UINT32_MAX)
+			throw std::length_error("String is too long");
+
+		const size_t length = size();
+		char* const newData = (char*)resource()->allocate(capacity + 1, 1);
+		memcpy(newData, c_str(), length + 1);
+		deallocate();
+
+		heap = { newData, (uint32_t)length, (uint32_t)capacity };
+		resourceBits |= heapFlag;
+	}
+
+	void steal(json_string& other) noexcept {
+		resourceBits = other.resourceBits;
+		memcpy((void*)buffer, (const void*)other.buffer, sizeof(buffer));
+		other.resourceBits &= ~stateBits;
+		other.setSize(0);
+	}
+
+	// Refers to the characters of the shared string other, keeping the own resource.
+	void share(const json_string& other) noexcept {
+		deallocate();
+		heap = other.heap;
+		resourceBits |= sharedFlag;
+	}
+
+	// Copies the characters of a shared string into storage of its own before they are modified.
+	void unshare() {
+		if (isShared()) {
+			const std::string_view characters(heap.data, heap.size);
+			resourceBits &= ~stateBits;
+			setSize(0);
+			append(characters.data(), characters.length());
+		}
+	}
+
+public:
+	json_string() noexcept : json_string(allocator_type()) {}
+
+	explicit json_string(const allocator_type& allocator) noexcept : resourceBits((uintptr_t)allocator.resource()), heap{} {
+		setSize(0);
+	}
+
+	json_string(const char* first, const char* last, const allocator_type& allocator = allocator_type()) : json_string(allocator) {
+		append(first, last - first);
+	}
+
+	explicit json_string(std::string_view s, const allocator_type& allocator = allocator_type()) : json_string(s.data(), s.data() + s.length(), allocator) {}
+
+	explicit json_string(const std::string& s, const allocator_type& allocator = allocator_type()) : json_string(std::string_view(s), allocator) {}
+
+	json_string(const char* s, const allocator_type& allocator = allocator_type()) : json_string(std::string_view(s), allocator) {}
+
+	// like the pmr containers copies use the default resource, not the one of other
+	json_string(const json_string& other) : json_string(other, allocator_type()) {}
+
+	// copies of shared strings are shared as well
+	json_string(const json_string& other, const allocator_type& allocator) : json_string(allocator) {
+		if (other.isShared()) {
+			share(other);
+		} else {
+			append(other.data(), other.size());
+		}
+	}
+
+	json_string(json_string&& other) noexcept {
+		steal(other);
+	}
+
+	json_string(json_string&& other, const allocator_type& allocator) {
+		if (other.resource() == allocator.resource()) {
+			steal(other);
+		} else {
+			new (this) json_string(std::as_const(other), allocator);
+		}
+	}
+
+	// Refers to s without copying it. The characters have to be followed by a '\0'
+	// and stay unchanged as long as any string shares them, like the keys of json_keys.
+	static json_string shared(std::string_view s, const allocator_type& allocator = allocator_type()) {
+		if (s.length() >= UINT32_MAX)
+			throw std::length_error("String is too long");
+
+		json_string result(allocator);
+		result.heap = { (char*)s.data(), (uint32_t)s.length(), (uint32_t)s.length() };
+		result.resourceBits |= sharedFlag;
+		return result;
+	}
+
+	~json_string() {
+		deallocate();
+	}
+
+	json_string& operator=(const json_string& other) {
+		if (this == &other) {
+		} else if (other.isShared()) {
+			share(other);
+		} else {
+			clear();
+			append(other.data(), other.size());
+		}
+		return *this;
+	}
+
+	json_string& operator=(json_string&& other) {
+		if (this == &other) {
+		} else if (other.resource() == resource()) {
+			deallocate();
+			steal(other);
+		} else if (other.isShared()) {
+			share(other);
+		} else {
+			clear();
+			append(other.data(), other.size());
+		}
+		return *this;
+	}
+
+	json_string& operator=(std::string_view s) {
+		// shared characters stay valid, so those may be dropped before s is copied
+		if (isShared())
+			clear();
+
+		// s might point into this string, so move it to the front instead of clearing first
+		if (s.length() <= capacity()) {
+			memmove(data(), s.data(), s.length());
+			setSize(s.length());
+		} else {
+			clear();
+			append(s.data(), s.length());
+		}
+		return *this;
+	}
+
+	allocator_type get_allocator() const noexcept {
+		return allocator_type(resource());
+	}
+
+	//----------------------[ accessors ]---------------------//
+
+	const char* data() const noexcept { return isInline() ? buffer : heap.data; }
+	const char* c_str() const noexcept { return data(); }
+
+	// shared strings get a copy of their own, as their characters may not be modified
+	char* data() {
+		unshare();
+		return isInline() ? buffer : heap.data;
+	}
+
+	bool is_shared() const noexcept { return isShared(); }
+
+	size_t size() const noexcept {
+		return isInline() ? inlineCapacity - buffer[inlineCapacity] : heap.size;
+	}
+
+	size_t length() const noexcept { return size(); }
+	bool empty() const noexcept { return size() == 0; }
+
+	size_t capacity() const noexcept {
+		return isInline() ? inlineCapacity : heap.capacity;
+	}
+
+	iterator begin() { return data(); }
+	iterator end() { return data() + size(); }
+	const_iterator begin() const noexcept { return data(); }
+	const_iterator end() const noexcept { return data() + size(); }
+
+	char& operator[](const size_t index) { return data()[index]; }
+	const char& operator[](const size_t index) const { return data()[index]; }
+
+	operator std::string_view() const noexcept {
+		return std::string_view(data(), size());
+	}
+
+	explicit operator std::string() const {
+		return std::string(data(), size());
+	}
+
+	//----------------------[ modifiers ]---------------------//
+
+	void reserve(const size_t newCapacity) {
+		unshare();
+		if (newCapacity > capacity())
+			reallocate(newCapacity);
+	}
+
+	void clear() noexcept {
+		if (isShared())
+			resourceBits &= ~sharedFlag;
+		setSize(0);
+	}
+
+	json_string& append(const char* s, const size_t count) {
+		unshare();
+		const size_t oldSize = size();
+		const size_t newSize = oldSize + count;
+		if (newSize > capacity()) {
+			// reallocate keeps the old buffer alive until s has been copied
+			const char* const oldData = data();
+			const bool aliasing = s >= oldData && s < oldData + oldSize;
+			const size_t offset = s - oldData;
+			reallocate(std::max(newSize, capacity() * 2));
+			if (aliasing)
+				s = data() + offset;
+		}
+		memmove(data() + oldSize, s, count);
+		setSize(newSize);
+		return *this;
+	}
+
+	json_string& append(const char* first, const char* last) {
+		return append(first, last - first);
+	}
+
+	json_string& append(std::string_view s) {
+		return append(s.data(), s.length());
+	}
+
+	void push_back(const char c) {
+		append(&c, 1);
+	}
+
+	json_string& operator+=(const char c) {
+		push_back(c);
+		return *this;
+	}
+
+	json_string& operator+=(std::string_view s) {
+		return append(s);
+	}
+
+	//----------------------[ comparison ]---------------------//
+
+	// interned strings are equal by address, so that is checked before the characters
+	friend bool operator==(const json_string& a, const json_string& b) noexcept {
+		return (a.data() == b.data() && a.size() == b.size()) || std::string_view(a) == std::string_view(b);
+	}
+
+	friend bool operator==(const json_string& a, std::string_view b) noexcept {
+		return (a.data() == b.data() && a.size() == b.size()) || std::string_view(a) == b;
+	}
+
+	friend bool operator==(const json_string& a, const char* b) noexcept {
+		return std::string_view(a) == b;
+	}
+
+	friend auto operator<=>(const json_string& a, const json_string& b) noexcept {
+		return std::string_view(a) <=> std::string_view(b);
+	}
+
+	friend auto operator<=>(const json_string& a, std::string_view b) noexcept {
+		return std::string_view(a) <=> b;
+	}
+
+	friend std::ostream& operator<<(std::ostream& out, const json_string& s) {
+		return out << std::string_view(s);
+	}
+};
+
+template<>
+struct std::hash<json_string> {
+	size_t operator()(const json_string& s) const noexcept {
+		return std::hash<std::string_view>()(s);
+	}
+};
+
+// Map from json_string keys to V that keeps its entries in insertion order in a single
+// vector, so iterating it walks contiguous memory. Small maps are searched linearly;
+// from linearLimit entries on, a flat open addressing table is kept as well, whose
+// slots hold 32 bits of the key hash next to the entry index. Lookups take
+// any string_view, so no temporary key has to be built. Erasing shifts the
+// following entries and rebuilds the table, as entry indices change.
+template<typename V>
+class ordered_map {
+public:
+	typedef json_string key_type;
+	typedef V mapped_type;
+	typedef std::pair<json_string, V> value_type;
+	typedef std::pmr::polymorphic_allocator<value_type> allocator_type;
+	typedef typename std::pmr::vector<value_type>::iterator iterator;
+	typedef typename std::pmr::vector<value_type>::const_iterator const_iterator;
+
+private:
+	static constexpr size_t linearLimit = 8;
+
+	std::pmr::vector<value_type> entries;
+	// 0 for empty slots, otherwise tag(key) << 32 | (index + 1)
+	std::pmr::vector<uint64_t> slots;
+
+	static uint32_t tag(std::string_view key) {
+		const uint64_t hash = std::hash<std::string_view>()(key);
+		return (uint32_t)(hash >> 32 ^ hash);
+	}
+
+	size_t findIndex(std::string_view key) const {
+		if (slots.empty()) {
+			for (size_t i = 0; i < entries.size(); i++) {
+				if (entries[i].first == key)
+					return i;
+			}
+			return entries.size();
+		}
+		return findIndex(key, tag(key));
+	}
+
+	size_t findIndex(std::string_view key, const uint32_t keyTag) const {
+		if (slots.empty())
+			return findIndex(key);
+
+		const size_t mask = slots.size() - 1;
+		for (size_t position = keyTag & mask; slots[position] != 0; position = (position + 1) & mask) {
+			const uint64_t slot = slots[position];
+			if ((uint32_t)(slot >> 32) == keyTag && entries[(uint32_t)slot - 1].first == key)
+				return (uint32_t)slot - 1;
+		}
+		return entries.size();
+	}
+
+	void insertSlot(const size_t index) {
+		const uint32_t keyTag = tag(entries[index].first);
+		const size_t mask = slots.size() - 1;
+		size_t position = keyTag & mask;
+		while (slots[position] != 0)
+			position = (position + 1) & mask;
+		slots[position] = (uint64_t)keyTag << 32 | (index + 1);
+	}
+
+	void rebuildSlots(const size_t capacity) {
+		slots.assign(capacity, 0);
+		for (size_t i = 0; i < entries.size(); i++)
+			insertSlot(i);
+	}
+
+	// Indexes the entry that was just appended, keeping the table at most half full.
+	// A table made by reserve exists before the entries do, so it is filled from the first one.
+	void indexBack() {
+		if (slots.empty() && entries.size() <= linearLimit)
+			return;
+		if (entries.size() >= UINT32_MAX)
+			throw std::length_error("Too many object members");
+
+		if (slots.size() < 2 * entries.size()) {
+			rebuildSlots(std::bit_ceil(4 * entries.size()));
+		} else {
+			insertSlot(entries.size() - 1);
+		}
+	}
+
+public:
+	ordered_map() = default;
+
+	explicit ordered_map(const allocator_type& allocator) : entries(allocator), slots(allocator) {}
+
+	ordered_map(std::initializer_list<value_type> list, const allocator_type& allocator = allocator_type()) : ordered_map(allocator) {
+		for (const value_type& entry : list)
+			try_emplace(entry.first, entry.second);
+	}
+
+	ordered_map(const ordered_map& other) = default;
+
+	ordered_map(const ordered_map& other, const allocator_type& allocator) : entries(other.entries, allocator), slots(other.slots, allocator) {}
+
+	ordered_map(ordered_map&& other) noexcept = default;
+
+	ordered_map(ordered_map&& other, const allocator_type& allocator) : entries(std::move(other.entries), allocator), slots(std::move(other.slots), allocator) {}
+
+	ordered_map& operator=(const ordered_map& other) = default;
+	ordered_map& operator=(ordered_map&& other) = default;
+
+	allocator_type get_allocator() const noexcept {
+		return entries.get_allocator();
+	}
+
+	//----------------------[ iteration ]---------------------//
+
+	iterator begin() noexcept { return entries.begin(); }
+	iterator end() noexcept { return entries.end(); }
+	const_iterator begin() const noexcept { return entries.begin(); }
+	const_iterator end() const noexcept { return entries.end(); }
+
+	size_t size() const noexcept { return entries.size(); }
+	bool empty() const noexcept { return entries.empty(); }
+
+	//----------------------[ lookup ]---------------------//
+
+	iterator find(std::string_view key) {
+		return entries.begin() + findIndex(key);
+	}
+
+	const_iterator find(std::string_view key) const {
+		return entries.begin() + findIndex(key);
+	}
+
+	// Lookups with a hash(key) computed in advance, which saves hashing the key again.
+	static uint32_t hash(std::string_view key) {
+		return tag(key);
+	}
+
+	iterator find(std::string_view key, const uint32_t keyHash) {
+		return entries.begin() + findIndex(key, keyHash);
+	}
+
+	const_iterator find(std::string_view key, const uint32_t keyHash) const {
+		return entries.begin() + findIndex(key, keyHash);
+	}
+
+	bool contains(std::string_view key) const {
+		return findIndex(key) != entries.size();
+	}
+
+	size_t count(std::string_view key) const {
+		return contains(key) ? 1 : 0;
+	}
+
+	V& at(std::string_view key) {
+		const size_t index = findIndex(key);
+		if (index == entries.size())
+			throw std::out_of_range("Unknown key");
+		return entries[index].second;
+	}
+
+	const V& at(std::string_view key) const {
+		const size_t index = findIndex(key);
+		if (index == entries.size())
+			throw std::out_of_range("Unknown key");
+		return entries[index].second;
+	}
+
+	V& operator[](std::string_view key) {
+		return try_emplace(key).first->second;
+	}
+
+	//----------------------[ modifiers ]---------------------//
+
+	// Keeps the existing value if key is already present, like std::map::try_emplace.
+	template<typename K, typename... Args> requires std::constructible_from<std::string_view, const K&>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		const size_t index = findIndex(key);
+		if (index != entries.size())
+			return { entries.begin() + index, false };
+
+		if constexpr (std::same_as<std::remove_cvref_t<K>, json_string>) {
+			entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		} else {
+			entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::string_view(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+		indexBack();
+		return { entries.end() - 1, true };
+	}
+
+	std::pair<iterator, bool> insert(const value_type& entry) {
+		return try_emplace(entry.first, entry.second);
+	}
+
+	std::pair<iterator, bool> insert(value_type&& entry) {
+		return try_emplace(std::move(entry.first), std::move(entry.second));
+	}
+
+	size_t erase(std::string_view key) {
+		const size_t index = findIndex(key);
+		if (index == entries.size())
+			return 0;
+
+		entries.erase(entries.begin() + index);
+		if (entries.size() <= linearLimit) {
+			slots.clear();
+		} else {
+			rebuildSlots(slots.size());
+		}
+		return 1;
+	}
+
+	void clear() noexcept {
+		entries.clear();
+		slots.clear();
+	}
+
+	void reserve(const size_t count) {
+		entries.reserve(count);
+		if (count > linearLimit && slots.size() < 2 * count)
+			rebuildSlots(std::bit_ceil(2 * count));
+	}
+};
+
+// Table of interned object keys. Documents parsed with it store their keys as shared
+// json_strings pointing into the table instead of a copy per object, and equal
+// keys compare by address once they are found. Object lookups still hash the
+// characters of the key, interning only saves the copies and the final comparison.
+// The table only grows, so it suits the fixed set of keys of a message format,
+// and it has to outlive every document parsed with it. It may be used by several threads.
+class json_keys {
+private:
+	// Recently interned keys of one table on this thread, so the keys every object
+	// repeats are found without hashing them in full or touching the shared lock.
+	struct cache {
+		static constexpr size_t size = 256;
+
+		uint64_t table = 0;
+		std::array<std::string_view, size> keys;
+
+		// Mixes the length with the first and last (up to) 8 bytes of key.
+		static size_t slot(std::string_view key) {
+			if (key.empty())
+				return 0;
+			uint64_t head = 0, tail = 0;
+			const size_t length = std::min<size_t>(key.length(), 8);
+			memcpy(&head, key.data(), length);
+			memcpy(&tail, key.data() + key.length() - length, length);
+			const uint64_t hash = (head * 0x9E3779B97F4A7C15 ^ tail ^ key.length()) * 0xFF51AFD7ED558CCD;
+			return hash >> 56;
+		}
+	};
+
+	static uint64_t nextId() {
+		static std::atomic<uint64_t> count{ 0 };
+		return ++count;
+	}
+
+	const uint64_t id = nextId();
+	std::pmr::monotonic_buffer_resource storage;
+	std::unordered_set<std::string_view> keys;
+	mutable std::shared_mutex mutex;
+
+	std::string_view insert(std::string_view key) {
+		{
+			const std::shared_lock lock(mutex);
+			const auto it = keys.find(key);
+			if (it != keys.end())
+				return *it;
+		}
+
+		// another thread might have added it in between
+		const std::unique_lock lock(mutex);
+		const auto it = keys.find(key);
+		if (it != keys.end())
+			return *it;
+
+		char* const data = (char*)storage.allocate(key.length() + 1, 1);
+		memcpy(data, key.data(), key.length());
+		data[key.length()] = '\0';
+		return *keys.emplace(data, key.length()).first;
+	}
+
+public:
+	json_keys() = default;
+
+	json_keys(const json_keys&) = delete;
+	json_keys& operator=(const json_keys&) = delete;
+
+	// Table shared by the whole program, it is never destroyed.
+	static json_keys& global() {
+		static json_keys* const table = new json_keys();
+		return *table;
+	}
+
+	// Returns the interned copy of key, which is followed by a '\0'.
+	// Tables are told apart by id, so a new table at the address of
+	// a destroyed one does not find its keys in the cache.
+	std::string_view intern(std::string_view key) {
+		thread_local cache recent;
+		if (recent.table != id) {
+			recent.table = id;
+			recent.keys.fill(std::string_view());
+		}
+
+		std::string_view& cached = recent.keys[cache::slot(key)];
+		if (cached.length() == key.length() && cached.data() != nullptr && memcmp(cached.data(), key.data(), key.length()) == 0)
+			return cached;
+		cached = insert(key);
+		return cached;
+	}
+
+	size_t size() const {
+		const std::shared_lock lock(mutex);
+		return keys.size();
+	}
+};
+
+// Tokens of json pointers (RFC 6901), shared by json_projection and json_path.
+struct json_pointer {
+	// Splits pointer at '/' and unescapes "~0" and "~1", the empty pointer has no tokens.
+	static std::vector<std::string> split(std::string_view pointer) {
+		std::vector<std::string> tokens;
+		if (pointer.empty())
+			return tokens;
+		if (pointer[0] != '/')
+			throw std::invalid_argument("Json pointer has to start with '/': " + std::string(pointer));
+
+		for (size_t begin = 1; begin <= pointer.length(); ) {
+			const size_t end = std::min(pointer.find('/', begin), pointer.length());
+			std::string& token = tokens.emplace_back();
+			for (size_t i = begin; i < end; i++) {
+				if (pointer[i] != '~') {
+					token += pointer[i];
+				} else if (i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+					token += pointer[++i] == '0' ? '~' : '/';
+				} else {
+					throw std::invalid_argument("Invalid escape in json pointer: " + std::string(pointer));
+				}
+			}
+			begin = end + 1;
+		}
+		return tokens;
+	}
+
+	// Whether token is an array index, which has no leading zeros.
+	static bool isIndex(std::string_view token, size_t& index) {
+		if (token.empty() || (token[0] == '0' && token.length() > 1))
+			return false;
+		const auto [end, error] = std::from_chars(token.data(), token.data() + token.length(), index);
+		return error == std::errc() && end == token.data() + token.length();
+	}
+};
+
+// Set of json pointers (RFC 6901) that json::parse builds a document from, with '*' as
+// an additional token that matches every key or index. The pointers are compiled into
+// a trie once. Selected values are kept whole. Objects on the way to them keep only
+// the selected members, and arrays keep their elements up to the last selected index,
+// with null in place of unselected ones, so the pointers stay valid in the result.
+// Everything else is skipped by matching brackets and quotes, without being validated.
+class json_projection {
+	friend class json;
+
+private:
+	struct node {
+		std::vector<std::pair<std::string, uint32_t>> keys;
+		// the keys that are array indices, ascending
+		std::vector<std::pair<size_t, uint32_t>> indices;
+		uint32_t any = 0;
+		bool whole = false;
+
+		// Returns the node selected by key, 0 if there is none (the root is never a child).
+		// Projections tend to be small, so the keys are searched linearly.
+		uint32_t child(std::string_view key) const {
+			for (const auto& [name, child] : keys) {
+				if (name == key)
+					return child;
+			}
+			return any;
+		}
+
+		uint32_t child(const size_t index) const {
+			for (const auto& [position, child] : indices) {
+				if (position == index)
+					return child;
+			}
+			return any;
+		}
+
+		// Elements from this index on are not selected.
+		size_t end() const {
+			return any != 0 ? SIZE_MAX : indices.empty() ? 0 : indices.back().first + 1;
+		}
+	};
+
+	std::vector<node> nodes;
+
+	// Adds the node selecting paths, the tokens of a '*' are merged into those of every
+	// key next to it, so each key leads to exactly one node.
+	uint32_t build(const std::vector<std::span<const std::string>>& paths) {
+		const uint32_t id = (uint32_t)nodes.size();
+		nodes.emplace_back();
+
+		std::vector<std::span<const std::string>> any;
+		std::vector<std::pair<std::string_view, std::vector<std::span<const std::string>>>> groups;
+		for (const std::span<const std::string> path : paths) {
+			if (path.empty()) {
+				nodes[id].whole = true;
+				return id;
+			}
+
+			if (path[0] == "*") {
+				any.push_back(path.subspan(1));
+				continue;
+			}
+			auto group = std::find_if(groups.begin(), groups.end(), [&](const auto& group) {
+				return group.first == path[0];
+			});
+			if (group == groups.end())
+				group = groups.insert(groups.end(), { path[0], {} });
+			group->second.push_back(path.subspan(1));
+		}
+
+		for (auto& [name, group] : groups) {
+			group.insert(group.end(), any.begin(), any.end());
+			const uint32_t child = build(group);
+			nodes[id].keys.emplace_back(name, child);
+
+			size_t index;
+			if (json_pointer::isIndex(name, index))
+				nodes[id].indices.emplace_back(index, child);
+		}
+		std::sort(nodes[id].indices.begin(), nodes[id].indices.end());
+
+		if (!any.empty()) {
+			const uint32_t child = build(any);
+			nodes[id].any = child;
+		}
+		return id;
+	}
+
+public:
+	explicit json_projection(std::span<const std::string_view> pointers) {
+		std::vector<std::vector<std::string>> tokens;
+		tokens.reserve(pointers.size());
+		for (const std::string_view pointer : pointers)
+			tokens.push_back(json_pointer::split(pointer));
+
+		std::vector<std::span<const std::string>> paths(tokens.begin(), tokens.end());
+		build(paths);
+	}
+
+	json_projection(std::initializer_list<std::string_view> pointers) : json_projection(std::span(pointers.begin(), pointers.size())) {}
+};
+
+// Read only view of a whole file. It is memory mapped where that is supported
+// (and read into a buffer elsewhere), so parsing from view() needs no copy.
+// json_cursor values that refer to view() stay valid as long as the file,
+// json_tape copies the strings it keeps and does not refer to it.
+class json_file {
+private:
+#if defined(JSON_MMAP)
+	const char* data = nullptr;
+	size_t length = 0;
+#else
+	std::string buffer;
+#endif
+
+public:
+	explicit json_file(const std::string& path) {
+#if defined(JSON_MMAP)
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd == -1)
+			throw std::system_error(errno, std::generic_category(), "Could not open " + path);
+
+		struct stat info;
+		if (::fstat(fd, &info) == -1) {
+			const int error = errno;
+			::close(fd);
+			throw std::system_error(error, std::generic_category(), "Could not stat " + path);
+		}
+
+		// empty files cannot be mapped
+		length = (size_t)info.st_size;
+		if (length != 0) {
+			void* const mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping == MAP_FAILED) {
+				const int error = errno;
+				::close(fd);
+				throw std::system_error(error, std::generic_category(), "Could not map " + path);
+			}
+			::madvise(mapping, length, MADV_SEQUENTIAL);
+			data = (const char*)mapping;
+		}
+		::close(fd);
+#else
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			throw std::runtime_error("Could not open " + path);
+
+		std::ostringstream contents;
+		contents << file.rdbuf();
+		buffer = std::move(contents).str();
+#endif
+	}
+
+	json_file(const json_file&) = delete;
+	json_file& operator=(const json_file&) = delete;
+
+#if defined(JSON_MMAP)
+	json_file(json_file&& other) noexcept : data(std::exchange(other.data, nullptr)), length(std::exchange(other.length, 0)) {}
+
+	json_file& operator=(json_file&& other) noexcept {
+		std::swap(data, other.data);
+		std::swap(length, other.length);
+		return *this;
+	}
+
+	~json_file() {
+		if (data != nullptr)
+			::munmap((void*)data, length);
+	}
+
+	std::string_view view() const {
+		return std::string_view(data, length);
+	}
+#else
+	json_file(json_file&&) noexcept = default;
+	json_file& operator=(json_file&&) noexcept = default;
+
+	std::string_view view() const {
+		return buffer;
+	}
+#endif
+};
+
+// Member of T that is bound to the json key name, see json_fields.
+template<typename T, typename M>
+struct json_member {
+	std::string_view name;
+	M T::* pointer;
+};
+
+template<typename T, typename M>
+constexpr json_member<T, M> json_field(std::string_view name, M T::* pointer) {
+	return { name, pointer };
+}
+
+// Binds the members of a struct to json keys, so json::parse_as reads documents straight into it.
+// Specializations list the members as a tuple of json_field:
+//   template<> struct json_fields<point> {
+//   	static constexpr auto members = std::make_tuple(json_field("x", &point::x), json_field("y", &point::y));
+//   };
+template<typename T>
+struct json_fields;
+
+template<typename T>
+concept json_bound = requires { std::tuple_size<std::remove_cvref_t<decltype(json_fields<T>::members)>>::value; };
+
+// Text json::write puts in front of the value of member I of T: the key quoted
+// and escaped, followed by ": ", and for all but the first member preceded by ','.
+template<typename T, size_t I>
+inline constexpr auto json_key_text = []() {
+	constexpr std::string_view name = std::get<I>(json_fields<T>::members).name;
+	constexpr auto escapedLength = [](const char c) -> size_t {
+		switch (c) {
+			case '\"':
+			case '\\':
+			case '\b':
+			case '\f':
+			case '\n':
+			case '\r':
+			case '\t':	return 2;
+			default:	return (unsigned char)c < 0x20 ? 6 : 1;
+		}
+	};
+	constexpr size_t length = [&]() {
+		size_t sum = I == 0 ? 4 : 5;
+		for (const char c : name)
+			sum += escapedLength(c);
+		return sum;
+	}();
+
+	std::array<char, length> text{};
+	size_t i = 0;
+	if (I != 0)
+		text[i++] = ',';
+	text[i++] = '\"';
+	for (const char c : name) {
+		constexpr char hex[] = "0123456789abcdef";
+		if (escapedLength(c) == 1) {
+			text[i++] = c;
+			continue;
+		}
+		text[i++] = '\\';
+		switch (c) {
+			case '\"':	text[i++] = '\"'; break;
+			case '\\':	text[i++] = '\\'; break;
+			case '\b':	text[i++] = 'b'; break;
+			case '\f':	text[i++] = 'f'; break;
+			case '\n':	text[i++] = 'n'; break;
+			case '\r':	text[i++] = 'r'; break;
+			case '\t':	text[i++] = 't'; break;
+			default: {
+				text[i++] = 'u';
+				text[i++] = '0';
+				text[i++] = '0';
+				text[i++] = hex[c >> 4];
+				text[i++] = hex[c & 0xF];
+			}
+		}
+	}
+	text[i++] = '\"';
+	text[i++] = ':';
+	text[i++] = ' ';
+	return text;
+}();
+
+// Perfect hash of the member names of T that json::parse_as looks keys up in.
+// The seed and the power of two size are searched at compile time, so that
+// every name has a slot of its own and a lookup is one hash and one comparison.
+template<typename T>
+struct json_key_table {
+	static constexpr size_t count = std::tuple_size_v<std::remove_cvref_t<decltype(json_fields<T>::members)>>;
+
+	static constexpr auto names = []<size_t... Is>(std::index_sequence<Is...>) {
+		return std::array<std::string_view, count>{ std::get<Is>(json_fields<T>::members).name... };
+	}(std::make_index_sequence<count>());
+
+	static constexpr uint32_t hash(std::string_view key, const uint32_t seed) {
+		uint32_t h = seed;
+		for (const char c : key)
+			h = (h ^ (unsigned char)c) * 16777619u;
+		return h ^ (h >> 15);
+	}
+
+	static constexpr std::pair<size_t, uint32_t> shape = []() {
+		for (size_t i = 0; i < count; i++) {
+			for (size_t j = i + 1; j < count; j++) {
+				if (names[i] == names[j])
+					throw "json_fields binds two members to the same key";
+			}
+		}
+		for (size_t size = std::bit_ceil(count * 2); ; size *= 2) {
+			for (uint32_t seed = 2166136261u; seed != 2166136261u + 64; seed++) {
+				bool distinct = true;
+				for (size_t i = 0; distinct && i < count; i++) {
+					for (size_t j = i + 1; distinct && j < count; j++)
+						distinct = ((hash(names[i], seed) ^ hash(names[j], seed)) & (size - 1)) != 0;
+				}
+				if (distinct)
+					return std::pair<size_t, uint32_t>(size, seed);
+			}
+		}
+	}();
+
+	static constexpr auto slots = []() {
+		std::array<size_t, shape.first> slots;
+		slots.fill(count);
+		for (size_t i = 0; i < count; i++)
+			slots[hash(names[i], shape.second) & (shape.first - 1)] = i;
+		return slots;
+	}();
+
+	// Returns the index of the member bound to key or count if there is none.
+	static constexpr size_t find(std::string_view key) {
+		const size_t member = slots[hash(key, shape.second) & (shape.first - 1)];
+		return member != count && names[member] == key ? member : count;
+	}
+};
+
+enum class json_errc : uint8_t {
+	ok,
+	empty_input,
+	unexpected_end,
+	unexpected_character,
+	invalid_escape,
+	number_out_of_range,
+	depth_exceeded
+};
+
+// Result of the non throwing parser: what went wrong and at which index of the input.
+struct json_error {
+	json_errc code = json_errc::ok;
+	size_t offset = 0;
+
+	explicit operator bool() const noexcept {
+		return code != json_errc::ok;
+	}
+
+	std::string_view message() const noexcept {
+		switch (code) {
+			using enum json_errc;
+			case ok:					return "ok";
+			case empty_input:			return "Invalid json (empty string)";
+			case unexpected_end:		return "Unexpected end of input";
+			case unexpected_character:	return "Unexpected character";
+			case invalid_escape:		return "Invalid escape sequence";
+			case number_out_of_range:	return "Number out of range";
+			case depth_exceeded:		return "Maximum nesting depth exceeded";
+			default:					return "Unknown error";
+		}
+	}
+};
+
+class json;
+
+typedef bool Boolean;
+typedef double Number;
+typedef int64_t Integer;
+typedef uint64_t Unsigned;
+typedef json_string String;
+typedef std::pmr::vector<json> Array;
+typedef ordered_map<json> Object;
+
+template<class T>
+concept json_data_type = isAnyOf<T, Boolean, Number, Integer, Unsigned, String, Array, Object>;
+
+// Output of the serializer: a buffer with append(data, length) like std::string,
+// or an output iterator over char.
+template<class S>
+concept json_sink = requires(S& sink, const char* data, size_t length) { sink.append(data, length); } ||
+	std::output_iterator<S, char>;
+
+class json {
+	friend class json_tape;
+	friend class json_cursor;
+	friend class json_push_parser;
+	friend class json_arena;
+
+public:
+	enum class json_type : uint8_t {
+		null,
+		boolean,
+		number,
+		integer,
+		unsigned_integer,
+		string,
+		array,
+		object
+	};
+
+	static std::string typeToString(json_type type) {
+		switch (type) {
+		using enum json_type;
+		case null:	return "null";
+		case boolean:	return "boolean";
+		case number:	return "number";
+		case integer:	return "integer";
+		case unsigned_integer:	return "unsigned_integer";
+		case string:	return "string";
+		case array:		return "array";
+		case object:	return "object";
+		default: throw std::runtime_error("Invalid json type");
+		}
+	}
+
+
+private:
+	// Strings are stored inside of the node, so short strings need no allocation at all.
+	// Numbers without fraction and exponent are kept as Integer if they fit,
+	// and as Unsigned if they only fit that. Unsigned never holds values of Integer.
+	typedef smartUnion<json_type, json_type::null, sizeof(String), Boolean, Number, Integer, Unsigned, String, Array, Object> json_data;
+
+	json_data data;
+
+public:
+
+	//----------------------[ constructors ]---------------------//
+	
+	json() = default;
+
+	template<json_data_type T> requires (!std::same_as<T, Unsigned>)
+	json(const T& newData) : data(newData) {}
+
+	template<json_data_type T> requires (!std::same_as<T, Unsigned>)
+	json(T&& newData) : data(std::move(newData)) {}
+
+	json(std::string_view newData) : data(String(newData)) {}
+
+	json(const std::string& newData) : data(String(newData)) {}
+
+	json(const char* newData) : data(String(std::string_view(newData))) {}
+
+	// other integer types are stored as Integer, or as Unsigned if they do not fit
+	template<std::integral I> requires (!isAnyOf<I, Boolean, Integer>)
+	json(const I newData) : data(std::in_range<Integer>(newData) ? json_data(Integer(newData)) : json_data(Unsigned(newData))) {}
+
+	
+	json(const json& otherJSON) : data(copy_json_data(otherJSON.data)) {}
+
+	json(json&& otherJSON) noexcept : data(std::move(otherJSON.data)) {}
+
+	static json_data copy_json_data(const json_data& data) {
+		switch (data.type) {
+		using enum json_type;
+		case boolean:	return data.copy<Boolean>();
+		case number:	return data.copy<Number>();
+		case integer:	return data.copy<Integer>();
+		case unsigned_integer:	return data.copy<Unsigned>();
+		case string:	return data.copy<String>();
+		case array:		return data.copy<Array>();
+		case object:	return data.copy<Object>();
+		default: return json_data();
+		}
+	}
+
+	//----------------------[ parsing ]---------------------//
+
+	// Containers nested deeper than this are rejected by parse and try_parse,
+	// so malformed input can not overflow the stack.
+	static constexpr size_t maxDepth = 1024;
+
+	// All strings and containers of the result are allocated from resource,
+	// pass a std::pmr::monotonic_buffer_resource (or use json_arena) to bump
+	// allocate the whole document instead of allocating each node separately.
+	static json parse(std::string_view txt, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		if (txt.length() < 2)
+			throw std::runtime_error("Invalid json (empty string)");
+
+		size_t index = 0;
+		if (isSpace(txt[0]))
+			skipSpaces(txt, index);
+
+		if (charAt(txt, index) == '{') {
+			return json::parseObject(txt, index, resource);
+		} else if (charAt(txt, index) == '[') {
+			return json::parseArray(txt, index, resource);
+		} else {
+			throw std::runtime_error("Invalid json");
+		}
+	}
+
+	static json parse(const std::string& txt, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		return parse(std::string_view(txt), resource);
+	}
+
+	static json parse(const char* txt, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		return parse(std::string_view(txt), resource);
+	}
+
+	static json parse(const char* txt, const size_t length, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		return parse(std::string_view(txt, length), resource);
+	}
+
+	static json parse(std::span<const char> txt, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		return parse(std::string_view(txt.data(), txt.size()), resource);
+	}
+
+	// Like parse, but malformed input is reported by the returned error instead of an exception,
+	// so rejecting it costs no more than parsing up to the error. value is only assigned on
+	// success. Allocating the document may still throw.
+	static json_error try_parse(std::string_view txt, json& value, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		if (txt.length() < 2)
+			return { json_errc::empty_input, 0 };
+
+		size_t index = 0;
+		if (isSpace(txt[0]))
+			skipSpaces(txt, index);
+
+		const char begin = charAt(txt, index);
+		if (begin != '{' && begin != '[')
+			return errorAt(txt, index);
+
+		return tryParseValue(txt, index, resource, value);
+	}
+
+	// Same as above, but the object keys are interned in keys instead of copied, see json_keys.
+	static json parse(std::string_view txt, json_keys& keys, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		const internScope scope(&keys);
+		return parse(txt, resource);
+	}
+
+	// Builds only the parts of the document selected by projection, see json_projection.
+	static json parse(std::string_view txt, const json_projection& projection, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		size_t index = 0;
+		if (!txt.empty() && isSpace(txt[0]))
+			skipSpaces(txt, index);
+
+		const char begin = charAt(txt, index);
+		if (begin != '{' && begin != '[')
+			throw std::runtime_error("Invalid json");
+
+		return parseProjected(txt, index, projection, 0, resource);
+	}
+
+	// Parses the file at path from a read only mapping of it instead of a copy.
+	static json parse_file(const std::string& path, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		const json_file file(path);
+		return parse(file.view(), resource);
+	}
+
+	// Two stage parser: first builds an index of all structural characters
+	// with vectorized classification of 64 byte blocks, then builds the tree
+	// by walking that index. Produces the same values as parse.
+	static json parse_fast(std::string_view txt, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		const std::vector<uint32_t> structurals = buildStructuralIndex(txt);
+		const uint32_t* structural = structurals.data();
+
+		const char begin = charAt(txt, *structural);
+		if (begin != '{' && begin != '[')
+			throw std::runtime_error("Invalid json");
+
+		return parseIndexedValue(txt, structural, resource);
+	}
+
+	static json parse_fast(std::string_view txt, json_keys& keys, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		const internScope scope(&keys);
+		return parse_fast(txt, resource);
+	}
+
+	// Walks the document without building it and reports every token to handler:
+	//   on_object_begin(), on_object_end(), on_array_begin(), on_array_end(),
+	//   on_key(std::string_view), on_string(std::string_view),
+	//   on_number(Number), on_integer(Integer), on_unsigned(Unsigned), on_boolean(Boolean), on_null()
+	// Callbacks the handler does not declare are skipped, integers go to
+	// on_number if there is no on_integer (or on_unsigned for those above INT64_MAX). The views passed to
+	// on_key and on_string are only valid until the callback returns.
+	// Memory use only grows with the nesting depth (and the longest escaped string).
+	template<typename H>
+	static void parse_events(std::string_view txt, H&& handler) {
+		if (txt.length() < 2)
+			throw std::runtime_error("Invalid json (empty string)");
+
+		size_t index = 0;
+		if (isSpace(txt[0]))
+			skipSpaces(txt, index);
+
+		const char begin = charAt(txt, index);
+		if (begin != '{' && begin != '[')
+			throw std::runtime_error("Invalid json");
+
+		std::string buffer;
+		emitValue(txt, index, handler, buffer);
+	}
+
+	// Reads the document straight into a T without building json nodes. T is a struct
+	// with a json_fields specialization, bool, an arithmetic type, std::string, std::optional,
+	// a std::vector like or std::map like (with string keys) container of those, or json.
+	// Members missing from the document keep their value, unknown keys are skipped.
+	template<typename T>
+	static void parse_into(std::string_view txt, T& value) {
+		size_t index = 0;
+		if (!txt.empty() && isSpace(txt[0]))
+			skipSpaces(txt, index);
+		readBound(txt, index, value);
+	}
+
+	template<typename T>
+	static T parse_as(std::string_view txt) {
+		T value{};
+		parse_into(txt, value);
+		return value;
+	}
+
+	// Parses a document whose top level is an array by splitting its elements
+	// across up to threads threads, other documents are parsed like with parse.
+	// The element boundaries are found by a sequential pre-scan that only
+	// matches brackets and strings. resource has to be thread safe.
+	static json parse_parallel(std::string_view txt, const unsigned threads = std::thread::hardware_concurrency(), std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		size_t index = 0;
+		if (!txt.empty() && isSpace(txt[0]))
+			skipSpaces(txt, index);
+
+		if (charAt(txt, index) != '[')
+			return parse(txt, resource);
+
+		return parseArrayParallel(txt, index, threads, resource, [resource](size_t) {
+			return resource;
+		});
+	}
+
+	static json parse_parallel(std::string_view txt, json_keys& keys, const unsigned threads = std::thread::hardware_concurrency(), std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		const internScope scope(&keys);
+		return parse_parallel(txt, threads, resource);
+	}
+
+	// Parses newline delimited json (one value per line, empty lines are skipped)
+	// on up to threads threads and returns the values in input order.
+	static std::vector<json> parse_lines(std::string_view txt, const unsigned threads = std::thread::hardware_concurrency()) {
+		std::vector<std::string_view> lines;
+		size_t offset = 0;
+		splitLines(txt, offset, SIZE_MAX, lines);
+
+		std::vector<json> results(lines.size());
+		parseLines(txt, lines, results.data(), threads);
+		return results;
+	}
+
+	// Same as above, but hands the values to callback in input order as soon as their
+	// batch is parsed, so only one batch of lines is held in memory at a time.
+	template<typename F> requires std::invocable<F&, json&&>
+	static void parse_lines(std::string_view txt, F&& callback, const unsigned threads = std::thread::hardware_concurrency()) {
+		const size_t batchSize = std::max(threads, 1u) * 1024;
+		std::vector<std::string_view> lines;
+		std::vector<json> results;
+
+		size_t offset = 0;
+		while (offset < txt.length()) {
+			lines.clear();
+			splitLines(txt, offset, batchSize, lines);
+
+			results.clear();
+			results.resize(lines.size());
+			parseLines(txt, lines, results.data(), threads);
+
+			for (json& value : results)
+				callback(std::move(value));
+		}
+	}
+
+private:
+	// The input is a non owning view that is not necessarily null terminated,
+	// so every lookahead that may run past the end goes through charAt.
+	inline static char charAt(std::string_view txt, const size_t index) {
+		return index < txt.length() ? txt[index] : '\0';
+	}
+
+	inline static bool isSpace(const char c) {
+		return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+	}
+
+	// Returns the first character in [it, end) that is not json whitespace.
+	static const char* findNonSpace(const char* it, const char* const end) {
+		// most tokens are followed by no or a single space,
+		// so check the first two characters before setting up vector registers
+		for (int i = 0; i < 2; i++, it++) {
+			if (it == end || !isSpace(*it))
+				return it;
+		}
+
+#if defined(JSON_SIMD_AVX2)
+		const __m256i space256 = _mm256_set1_epi8(' ');
+		const __m256i newline256 = _mm256_set1_epi8('\n');
+		const __m256i tab256 = _mm256_set1_epi8('\t');
+		const __m256i carriage256 = _mm256_set1_epi8('\r');
+		for (; end - it >= 32; it += 32) {
+			const __m256i chunk = _mm256_loadu_si256((const __m256i*)it);
+			const __m256i spaces = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space256), _mm256_cmpeq_epi8(chunk, newline256)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, tab256), _mm256_cmpeq_epi8(chunk, carriage256))
+			);
+			const uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(spaces);
+			if (mask != 0)
+				return it + std::countr_zero(mask);
+		}
+#endif
+#if defined(JSON_SIMD_SSE2)
+		const __m128i space128 = _mm_set1_epi8(' ');
+		const __m128i newline128 = _mm_set1_epi8('\n');
+		const __m128i tab128 = _mm_set1_epi8('\t');
+		const __m128i carriage128 = _mm_set1_epi8('\r');
+		for (; end - it >= 16; it += 16) {
+			const __m128i chunk = _mm_loadu_si128((const __m128i*)it);
+			const __m128i spaces = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, space128), _mm_cmpeq_epi8(chunk, newline128)),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, tab128), _mm_cmpeq_epi8(chunk, carriage128))
+			);
+			const uint32_t mask = ~(uint32_t)_mm_movemask_epi8(spaces) & 0xFFFF;
+			if (mask != 0)
+				return it + std::countr_zero(mask);
+		}
+#endif
+		while (it != end && isSpace(*it))
+			it++;
+		return it;
+	}
+
+	// Moves index past the current character to the next token,
+	// or to the end of the input if there is none.
+	inline static void skipSpaces(std::string_view txt, size_t& index) {
+		if (++index >= txt.length())
+			return;
+		index = findNonSpace(txt.data() + index, txt.data() + txt.length()) - txt.data();
+	}
+
+	typedef json (*parser)(std::string_view txt, size_t& index, std::pmr::memory_resource* resource);
+
+	static const parser getParser(const char begin) {
+		switch (begin) {
+			using namespace std::string_literals;
+			case '{':			return &json::parseObject;
+			case '[':			return &json::parseArray;
+			case '\"':			return &json::parseString;
+			case 't':
+			case 'f':			return &json::parseBoolean;
+			case '-':
+			case '0' ... '9':	return &json::parseNumber;
+			case 'n':			return &json::parseNull;
+			default: throw std::runtime_error("Invalid symbole begin: "s + begin);
+		}
+	}
+
+	static json parseNull(std::string_view txt, size_t& index, std::pmr::memory_resource*) {
+		if (txt.length() > index + 3 && txt.substr(index, 4) == "null") {
+			index += 3;
+			return json();
+		} else {
+			throw parsingError(txt, index);
+		}
+	}
+
+	static json parseBoolean(std::string_view txt, size_t& index, std::pmr::memory_resource*) {
+		if (index < txt.length()) {
+			if (txt.substr(index, 5) == "false") {
+				index += 4;
+				return json(false);
+			} else if (txt.substr(index, 4) == "true") {
+				index += 3;
+				return json(true);
+			}
+		}
+		throw parsingError(txt, index);
+	}
+	
+	inline static bool isDigit(const char c) {
+		return c >= '0' && c <= '9';
+	}
+
+	inline static json_error errorAt(std::string_view txt, const size_t index) {
+		return { index < txt.length() ? json_errc::unexpected_character : json_errc::unexpected_end, index };
+	}
+
+	// Whether the valid number [begin, end) is out of range because it is
+	// too close to zero, which is the case if its decimal exponent is negative.
+	static bool isUnderflow(const char* it, const char* const end) {
+		if (*it == '-')
+			it++;
+
+		int64_t magnitude = 0;
+		bool significant = false;
+		for (; it != end && isDigit(*it); it++) {
+			significant |= *it != '0';
+			magnitude += significant;
+		}
+		if (it != end && *it == '.') {
+			for (it++; it != end && isDigit(*it); it++) {
+				significant |= *it != '0';
+				magnitude -= !significant;
+			}
+		}
+		if (it == end)
+			return false;
+
+		// exponents that do not even fit int64_t only depend on their sign
+		const bool negative = it[1] == '-';
+		it += it[1] == '-' || it[1] == '+' ? 2 : 1;
+		int64_t exponent;
+		if (std::from_chars(it, end, exponent).ec != std::errc())
+			return negative;
+		return magnitude + (negative ? -exponent : exponent) < 0;
+	}
+
+	static json_error tryParseNumber(std::string_view txt, size_t& index, json& value) {
+		const char* const begin = txt.data() + index;
+		const char* const end = txt.data() + txt.length();
+		const char* it = begin;
+
+		// validate the json number grammar in place:
+		// '-'? ('0' | [1-9][0-9]*) ('.' [0-9]+)? ([eE] [+-]? [0-9]+)?
+		const auto skipDigits = [&]() {
+			if (it >= end || !isDigit(*it))
+				return false;
+			while (++it != end && isDigit(*it));
+			return true;
+		};
+
+		if (it < end && *it == '-')
+			it++;
+
+		if (it < end && *it == '0') {
+			it++;
+		} else if (!skipDigits()) {
+			return errorAt(txt, it - txt.data());
+		}
+
+		bool integral = true;
+		if (it != end && *it == '.') {
+			it++;
+			if (!skipDigits())
+				return errorAt(txt, it - txt.data());
+			integral = false;
+		}
+
+		if (it != end && (*it == 'e' || *it == 'E')) {
+			if (++it != end && (*it == '+' || *it == '-'))
+				it++;
+			if (!skipDigits())
+				return errorAt(txt, it - txt.data());
+			integral = false;
+		}
+
+		// integers that overflow Integer are kept as Unsigned if they are positive,
+		// others fall through to Number, as does -0
+		if (integral && !(it - begin == 2 && *begin == '-' && begin[1] == '0')) {
+			Integer data;
+			Unsigned unsignedData;
+			if (std::from_chars(begin, it, data).ec == std::errc()) {
+				index += (it - begin) - 1;
+				value = json(data);
+				return {};
+			} else if (*begin != '-' && std::from_chars(begin, it, unsignedData).ec == std::errc()) {
+				index += (it - begin) - 1;
+				value = json(unsignedData);
+				return {};
+			}
+		}
+
+		// from_chars is locale independent and rounds correctly,
+		// numbers too small for a double are rounded to zero
+		double data;
+		if (std::from_chars(begin, it, data).ec != std::errc()) {
+			if (!isUnderflow(begin, it))
+				return { json_errc::number_out_of_range, index };
+			data = *begin == '-' ? -0.0 : 0.0;
+		}
+
+		index += (it - begin) - 1;
+		value = json(data);
+		return {};
+	}
+
+	static json parseNumber(std::string_view txt, size_t& index, std::pmr::memory_resource*) {
+		json value;
+		if (const json_error error = tryParseNumber(txt, index, value))
+			throw parsingError(txt, error);
+		return value;
+	}
+
+	// Returns the first quote, backslash or control character in [it, end),
+	// which are the only characters that end a plain run of string body.
+	static const char* findStringSpecial(const char* it, const char* const end) {
+#if defined(JSON_SIMD_AVX2)
+		const __m256i quote256 = _mm256_set1_epi8('\"');
+		const __m256i backslash256 = _mm256_set1_epi8('\\');
+		const __m256i control256 = _mm256_set1_epi8(0x1F);
+		for (; end - it >= 32; it += 32) {
+			const __m256i chunk = _mm256_loadu_si256((const __m256i*)it);
+			const __m256i specials = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote256), _mm256_cmpeq_epi8(chunk, backslash256)),
+				_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control256), chunk)
+			);
+			const uint32_t mask = (uint32_t)_mm256_movemask_epi8(specials);
+			if (mask != 0)
+				return it + std::countr_zero(mask);
+		}
+#endif
+#if defined(JSON_SIMD_SSE2)
+		const __m128i quote128 = _mm_set1_epi8('\"');
+		const __m128i backslash128 = _mm_set1_epi8('\\');
+		const __m128i control128 = _mm_set1_epi8(0x1F);
+		for (; end - it >= 16; it += 16) {
+			const __m128i chunk = _mm_loadu_si128((const __m128i*)it);
+			const __m128i specials = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote128), _mm_cmpeq_epi8(chunk, backslash128)),
+				_mm_cmpeq_epi8(_mm_min_epu8(chunk, control128), chunk)
+			);
+			const uint32_t mask = (uint32_t)_mm_movemask_epi8(specials);
+			if (mask != 0)
+				return it + std::countr_zero(mask);
+		}
+#endif
+		while (it != end && *it != '\"' && *it != '\\' && (unsigned char)*it > 0x1F)
+			it++;
+		return it;
+	}
+
+	// Returns the first quote or bracket (and with COMMAS the first ',') in [it, end).
+	// '[' and ']' differ from '{' and '}' only in bit 5, so setting it leaves
+	// two brackets to compare against.
+	template<bool COMMAS = false>
+	static const char* findBracketOrQuote(const char* it, const char* const end) {
+#if defined(JSON_SIMD_AVX2)
+		const __m256i quote256 = _mm256_set1_epi8('\"');
+		const __m256i comma256 = _mm256_set1_epi8(COMMAS ? ',' : '\"');
+		const __m256i open256 = _mm256_set1_epi8('{');
+		const __m256i close256 = _mm256_set1_epi8('}');
+		const __m256i bit256 = _mm256_set1_epi8(0x20);
+		for (; end - it >= 32; it += 32) {
+			const __m256i chunk = _mm256_loadu_si256((const __m256i*)it);
+			const __m256i folded = _mm256_or_si256(chunk, bit256);
+			const __m256i specials = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote256), _mm256_cmpeq_epi8(chunk, comma256)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(folded, open256), _mm256_cmpeq_epi8(folded, close256))
+			);
+			const uint32_t mask = (uint32_t)_mm256_movemask_epi8(specials);
+			if (mask != 0)
+				return it + std::countr_zero(mask);
+		}
+#endif
+#if defined(JSON_SIMD_SSE2)
+		const __m128i quote128 = _mm_set1_epi8('\"');
+		const __m128i comma128 = _mm_set1_epi8(COMMAS ? ',' : '\"');
+		const __m128i open128 = _mm_set1_epi8('{');
+		const __m128i close128 = _mm_set1_epi8('}');
+		const __m128i bit128 = _mm_set1_epi8(0x20);
+		for (; end - it >= 16; it += 16) {
+			const __m128i chunk = _mm_loadu_si128((const __m128i*)it);
+			const __m128i folded = _mm_or_si128(chunk, bit128);
+			const __m128i specials = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote128), _mm_cmpeq_epi8(chunk, comma128)),
+				_mm_or_si128(_mm_cmpeq_epi8(folded, open128), _mm_cmpeq_epi8(folded, close128))
+			);
+			const uint32_t mask = (uint32_t)_mm_movemask_epi8(specials);
+			if (mask != 0)
+				return it + std::countr_zero(mask);
+		}
+#endif
+		while (it != end && *it != '\"' && (!COMMAS || *it != ',') && (*it | 0x20) != '{' && (*it | 0x20) != '}')
+			it++;
+		return it;
+	}
+
+	// Returns the closing quote of the string starting at the quote it points to.
+	static const char* skipString(std::string_view txt, const char* it) {
+		const char* const end = txt.data() + txt.length();
+		for (it++; (it = findStringSpecial(it, end)) != end; it++) {
+			if (*it == '\"')
+				return it;
+			if (*it == '\\' && ++it == end)
+				break;
+		}
+		throw parsingError(txt, txt.length());
+	}
+
+	static json_error readHex(std::string_view txt, const char* it, uint32_t& value) {
+		if (txt.data() + txt.length() - it < 4)
+			return { json_errc::unexpected_end, txt.length() };
+
+		value = 0;
+		for (const char* const end = it + 4; it != end; it++) {
+			const char c = *it;
+			value <<= 4;
+			if (isDigit(c)) {
+				value |= c - '0';
+			} else if (c >= 'a' && c <= 'f') {
+				value |= c - 'a' + 10;
+			} else if (c >= 'A' && c <= 'F') {
+				value |= c - 'A' + 10;
+			} else {
+				return { json_errc::invalid_escape, (size_t)(it - txt.data()) };
+			}
+		}
+		return {};
+	}
+
+	template<typename S>
+	static void appendUtf8(S& data, const uint32_t codepoint) {
+		if (codepoint < 0x80) {
+			data += (char)codepoint;
+		} else if (codepoint < 0x800) {
+			data += (char)(0xC0 | codepoint >> 6);
+			data += (char)(0x80 | (codepoint & 0x3F));
+		} else if (codepoint < 0x10000) {
+			data += (char)(0xE0 | codepoint >> 12);
+			data += (char)(0x80 | (codepoint >> 6 & 0x3F));
+			data += (char)(0x80 | (codepoint & 0x3F));
+		} else {
+			data += (char)(0xF0 | codepoint >> 18);
+			data += (char)(0x80 | (codepoint >> 12 & 0x3F));
+			data += (char)(0x80 | (codepoint >> 6 & 0x3F));
+			data += (char)(0x80 | (codepoint & 0x3F));
+		}
+	}
+
+	// Decodes the escape sequence starting at the backslash 'it' points to
+	// and moves it to the position after it.
+	template<typename S>
+	static json_error readEscape(std::string_view txt, const char*& it, S& data) {
+		const char* const end = txt.data() + txt.length();
+		if (++it == end)
+			return { json_errc::unexpected_end, txt.length() };
+
+		switch (*it) {
+			case '\"':	data += '\"'; break;
+			case '\\':	data += '\\'; break;
+			case '/':	data += '/'; break;
+			case 'b':	data += '\b'; break;
+			case 'f':	data += '\f'; break;
+			case 'n':	data += '\n'; break;
+			case 'r':	data += '\r'; break;
+			case 't':	data += '\t'; break;
+			case 'u': {
+				uint32_t codepoint;
+				if (const json_error error = readHex(txt, it + 1, codepoint))
+					return error;
+				it += 4;
+				if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+					return { json_errc::invalid_escape, (size_t)(it - 5 - txt.data()) };
+				} else if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+					// characters outside of the BMP are encoded as surrogate pairs
+					if (end - it < 7 || it[1] != '\\' || it[2] != 'u')
+						return { json_errc::invalid_escape, (size_t)(it + 1 - txt.data()) };
+					uint32_t low;
+					if (const json_error error = readHex(txt, it + 3, low))
+						return error;
+					if (low < 0xDC00 || low > 0xDFFF)
+						return { json_errc::invalid_escape, (size_t)(it + 1 - txt.data()) };
+					codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+					it += 6;
+				}
+				appendUtf8(data, codepoint);
+				break;
+			}
+			default: return { json_errc::invalid_escape, (size_t)(it - txt.data()) };
+		}
+		it++;
+		return {};
+	}
+
+	// Appends the decoded contents of the string starting at the quote at index to data,
+	// which only needs += for single characters and append(first, last) for runs.
+	template<typename S>
+	static json_error tryDecodeString(std::string_view txt, size_t& index, S& data) {
+		const char* const end = txt.data() + txt.length();
+		const char* const begin = txt.data() + index + 1;
+		const char* it = findStringSpecial(begin, end);
+
+		// strings without escapes are copied in one go
+		data.append(begin, it);
+		while (it != end && *it != '\"') {
+			if (*it != '\\')
+				return { json_errc::unexpected_character, (size_t)(it - txt.data()) };
+
+			if (const json_error error = readEscape(txt, it, data))
+				return error;
+			const char* const run = it;
+			it = findStringSpecial(it, end);
+			data.append(run, it);
+		}
+
+		if (it == end)
+			return { json_errc::unexpected_end, txt.length() };
+
+		index = it - txt.data();
+		return {};
+	}
+
+	template<typename S>
+	static void decodeString(std::string_view txt, size_t& index, S& data) {
+		if (const json_error error = tryDecodeString(txt, index, data))
+			throw parsingError(txt, error);
+	}
+
+	static String readString(std::string_view txt, size_t& index, std::pmr::memory_resource* resource) {
+		String data(resource);
+		decodeString(txt, index, data);
+		return data;
+	}
+
+	static json parseString(std::string_view txt, size_t& index, std::pmr::memory_resource* resource) {
+		return json(readString(txt, index, resource));
+	}
+
+	// The key table of the current parse on this thread, nullptr if keys are copied.
+	static json_keys*& internedKeys() {
+		thread_local json_keys* keys = nullptr;
+		return keys;
+	}
+
+	struct internScope {
+		json_keys* const previous;
+
+		explicit internScope(json_keys* keys) : previous(std::exchange(internedKeys(), keys)) {}
+
+		~internScope() {
+			internedKeys() = previous;
+		}
+	};
+
+	static String makeKey(std::string_view key, std::pmr::memory_resource* resource) {
+		json_keys* const keys = internedKeys();
+		return keys == nullptr ? String(key, resource) : String::shared(keys->intern(key), resource);
+	}
+
+	// Keys without escapes are interned straight from the input, others are decoded
+	// into a buffer first, so interned keys are never copied into resource.
+	static json_error tryReadKey(std::string_view txt, size_t& index, std::pmr::memory_resource* resource, String& name) {
+		if (internedKeys() == nullptr)
+			return tryDecodeString(txt, index, name);
+
+		thread_local std::string buffer;
+		std::string_view key;
+		if (const json_error error = tryReadEventString(txt, index, buffer, key))
+			return error;
+		name = makeKey(key, resource);
+		return {};
+	}
+
+	static String readKey(std::string_view txt, size_t& index, std::pmr::memory_resource* resource) {
+		String name(resource);
+		if (const json_error error = tryReadKey(txt, index, resource, name))
+			throw parsingError(txt, error);
+		return name;
+	}
+
+	// Elements (or members) of the containers that are currently being parsed are collected
+	// on one stack per thread, so every container is allocated once with its final size.
+	// Once the outermost container is done, a stack that grew beyond retainedCapacity
+	// is released, so threads do not keep the memory of their largest document.
+	template<typename T>
+	struct elementStack {
+		static constexpr size_t retainedCapacity = 4096;
+
+		std::vector<T>& elements;
+		const size_t begin;
+
+		elementStack() : elements(stack()), begin(elements.size()) {}
+
+		~elementStack() {
+			elements.erase(elements.begin() + begin, elements.end());
+			if (begin == 0 && elements.capacity() > retainedCapacity)
+				elements.shrink_to_fit();
+		}
+
+		static std::vector<T>& stack() {
+			thread_local std::vector<T> elements;
+			return elements;
+		}
+
+		void push(T&& element) {
+			elements.push_back(std::move(element));
+		}
+
+		json collect(std::pmr::memory_resource* resource) {
+			if constexpr (std::same_as<T, json>) {
+				Array data(resource);
+				data.reserve(elements.size() - begin);
+				for (auto it = elements.begin() + begin; it != elements.end(); it++)
+					data.push_back(std::move(*it));
+				return json(std::move(data));
+			} else {
+				Object data(resource);
+				data.reserve(elements.size() - begin);
+				for (auto it = elements.begin() + begin; it != elements.end(); it++)
+					data.try_emplace(std::move(it->first), std::move(it->second));
+				return json(std::move(data));
+			}
+		}
+	};
+
+	// Non-throwing parser of the document tree that parse, try_parse and the getParser
+	// table share, the throwing ones only turn the error of the outermost value into one.
+	// Numbers and strings are read by tryParseNumber and tryDecodeString everywhere,
+	// but emitValue, parseProjected, forEachMember, parseIndexedValue and the json_tape
+	// builder walk containers with loops of their own and throw.
+	// depth is the number of containers around the value, deeper ones than maxDepth
+	// are rejected before they can overflow the stack.
+	static json_error tryParseValue(std::string_view txt, size_t& index, std::pmr::memory_resource* resource, json& value, const size_t depth = 0) {
+		switch (charAt(txt, index)) {
+			case '{':	return tryParseObject(txt, index, resource, value, depth);
+			case '[':	return tryParseArray(txt, index, resource, value, depth);
+			case '\"': {
+				String data(resource);
+				const json_error error = tryDecodeString(txt, index, data);
+				if (!error)
+					value = json(std::move(data));
+				return error;
+			}
+			case 't':
+				if (txt.substr(index, 4) != "true")
+					break;
+				index += 3;
+				value = json(true);
+				return {};
+			case 'f':
+				if (txt.substr(index, 5) != "false")
+					break;
+				index += 4;
+				value = json(false);
+				return {};
+			case 'n':
+				if (txt.substr(index, 4) != "null")
+					break;
+				index += 3;
+				value = json();
+				return {};
+			case '-':
+			case '0' ... '9':	return tryParseNumber(txt, index, value);
+		}
+		return errorAt(txt, index);
+	}
+
+	static json_error tryParseArray(std::string_view txt, size_t& index, std::pmr::memory_resource* resource, json& value, const size_t depth = 0) {
+		if (depth >= maxDepth)
+			return { json_errc::depth_exceeded, index };
+
+		skipSpaces(txt, index);
+		if (charAt(txt, index) == ']') {
+			value = json(Array(resource));
+			return {};
+		}
+
+		elementStack<json> data;
+		while (true) {
+			json element;
+			if (const json_error error = tryParseValue(txt, index, resource, element, depth + 1))
+				return error;
+			data.push(std::move(element));
+			skipSpaces(txt, index);
+
+			const char next = charAt(txt, index);
+			if (next == ']')
+				break;
+			if (next != ',')
+				return errorAt(txt, index);
+			skipSpaces(txt, index);
+		}
+
+		value = data.collect(resource);
+		return {};
+	}
+
+	static json_error tryParseObject(std::string_view txt, size_t& index, std::pmr::memory_resource* resource, json& value, const size_t depth = 0) {
+		if (depth >= maxDepth)
+			return { json_errc::depth_exceeded, index };
+
+		skipSpaces(txt, index);
+		if (charAt(txt, index) == '}') {
+			value = json(Object(resource));
+			return {};
+		}
+
+		elementStack<Object::value_type> data;
+		while (true) {
+			if (charAt(txt, index) != '\"')
+				return errorAt(txt, index);
+
+			String name(resource);
+			if (const json_error error = tryReadKey(txt, index, resource, name))
+				return error;
+			skipSpaces(txt, index);
+			if (charAt(txt, index) != ':')
+				return errorAt(txt, index);
+			skipSpaces(txt, index);
+
+			json member;
+			if (const json_error error = tryParseValue(txt, index, resource, member, depth + 1))
+				return error;
+			data.push({ std::move(name), std::move(member) });
+			skipSpaces(txt, index);
+
+			const char next = charAt(txt, index);
+			if (next == '}')
+				break;
+			if (next != ',')
+				return errorAt(txt, index);
+			skipSpaces(txt, index);
+		}
+
+		value = data.collect(resource);
+		return {};
+	}
+
+	static json parseArray(std::string_view txt, size_t& index, std::pmr::memory_resource* resource) {
+		json value;
+		if (const json_error error = tryParseArray(txt, index, resource, value))
+			throw parsingError(txt, error);
+		return value;
+	}
+
+	static json parseObject(std::string_view txt, size_t& index, std::pmr::memory_resource* resource) {
+		json value;
+		if (const json_error error = tryParseObject(txt, index, resource, value))
+			throw parsingError(txt, error);
+		return value;
+	}
+
+	//----------------------[ events ]---------------------//
+
+	// Strings without escapes are passed as views into the input,
+	// all others are decoded into buffer, which is reused for every string.
+	static json_error tryReadEventString(std::string_view txt, size_t& index, std::string& buffer, std::string_view& value) {
+		const char* const begin = txt.data() + index + 1;
+		const char* const it = findStringSpecial(begin, txt.data() + txt.length());
+		if (it != txt.data() + txt.length() && *it == '\"') {
+			index = it - txt.data();
+			value = std::string_view(begin, it - begin);
+			return {};
+		}
+
+		buffer.clear();
+		if (const json_error error = tryDecodeString(txt, index, buffer))
+			return error;
+		value = buffer;
+		return {};
+	}
+
+	static std::string_view readEventString(std::string_view txt, size_t& index, std::string& buffer) {
+		std::string_view value;
+		if (const json_error error = tryReadEventString(txt, index, buffer, value))
+			throw parsingError(txt, error);
+		return value;
+	}
+
+	template<typename H>
+	static void emitValue(std::string_view txt, size_t& index, H& handler, std::string& buffer) {
+		switch (charAt(txt, index)) {
+			case '{': emitObject(txt, index, handler, buffer); break;
+			case '[': emitArray(txt, index, handler, buffer); break;
+			case '\"': {
+				const std::string_view value = readEventString(txt, index, buffer);
+				if constexpr (requires { handler.on_string(value); })
+					handler.on_string(value);
+				break;
+			}
+			default: {
+				const json value = getParser(charAt(txt, index))(txt, index, nullptr);
+				if (value.data.type == json_type::number) {
+					if constexpr (requires { handler.on_number(Number()); })
+						handler.on_number(value.data.get<Number>());
+				} else if (value.data.type == json_type::integer) {
+					if constexpr (requires { handler.on_integer(Integer()); }) {
+						handler.on_integer(value.data.get<Integer>());
+					} else if constexpr (requires { handler.on_number(Number()); }) {
+						handler.on_number((Number)value.data.get<Integer>());
+					}
+				} else if (value.data.type == json_type::unsigned_integer) {
+					if constexpr (requires { handler.on_unsigned(Unsigned()); }) {
+						handler.on_unsigned(value.data.get<Unsigned>());
+					} else if constexpr (requires { handler.on_number(Number()); }) {
+						handler.on_number((Number)value.data.get<Unsigned>());
+					}
+				} else if (value.data.type == json_type::boolean) {
+					if constexpr (requires { handler.on_boolean(Boolean()); })
+						handler.on_boolean(value.data.get<Boolean>());
+				} else {
+					if constexpr (requires { handler.on_null(); })
+						handler.on_null();
+				}
+			}
+		}
+	}
+
+	template<typename H>
+	static void emitArray(std::string_view txt, size_t& index, H& handler, std::string& buffer) {
+		if constexpr (requires { handler.on_array_begin(); })
+			handler.on_array_begin();
+
+		skipSpaces(txt, index);
+		if (charAt(txt, index) != ']') {
+			while (true) {
+				emitValue(txt, index, handler, buffer);
+				skipSpaces(txt, index);
+
+				const char next = charAt(txt, index);
+				if (next == ']')
+					break;
+				if (next != ',')
+					throw parsingError(txt, index);
+				skipSpaces(txt, index);
+			}
+		}
+
+		if constexpr (requires { handler.on_array_end(); })
+			handler.on_array_end();
+	}
+
+	template<typename H>
+	static void emitObject(std::string_view txt, size_t& index, H& handler, std::string& buffer) {
+		if constexpr (requires { handler.on_object_begin(); })
+			handler.on_object_begin();
+
+		skipSpaces(txt, index);
+		if (charAt(txt, index) != '}') {
+			while (true) {
+				if (charAt(txt, index) != '\"')
+					throw parsingError(txt, index);
+
+				const std::string_view name = readEventString(txt, index, buffer);
+				if constexpr (requires { handler.on_key(name); })
+					handler.on_key(name);
+				skipSpaces(txt, index);
+				if (charAt(txt, index) != ':')
+					throw parsingError(txt, index);
+				skipSpaces(txt, index);
+
+				emitValue(txt, index, handler, buffer);
+				skipSpaces(txt, index);
+
+				const char next = charAt(txt, index);
+				if (next == '}')
+					break;
+				if (next != ',')
+					throw parsingError(txt, index);
+				skipSpaces(txt, index);
+			}
+		}
+
+		if constexpr (requires { handler.on_object_end(); })
+			handler.on_object_end();
+	}
+
+	//----------------------[ skipping ]---------------------//
+
+	// Returns the index of the last character of the value starting at index.
+	static size_t skipValue(std::string_view txt, const size_t index) {
+		const char* const begin = txt.data();
+		const char* const end = begin + txt.length();
+		const char* it = begin + index;
+
+		switch (charAt(txt, index)) {
+			case '\"': return skipString(txt, it) - begin;
+			case '{':
+			case '[': {
+				size_t depth = 0;
+				while ((it = findBracketOrQuote(it, end)) != end) {
+					if (*it == '\"') {
+						it = skipString(txt, it);
+					} else if ((*it | 0x20) == '{') {
+						depth++;
+					} else if (--depth == 0) {
+						return it - begin;
+					}
+					it++;
+				}
+				throw parsingError(txt, txt.length());
+			}
+			case '\0': throw parsingError(txt, index);
+			default: {
+				// scalars end at the next delimiter
+				while (it + 1 != end && !isSpace(it[1]) && it[1] != ',' && it[1] != ']' && it[1] != '}')
+					it++;
+				return it - begin;
+			}
+		}
+	}
+
+	//----------------------[ projection ]---------------------//
+
+	// Scalars below a node that selects something inside of them become null.
+	static json parseProjected(std::string_view txt, size_t& index, const json_projection& projection, const uint32_t node, std::pmr::memory_resource* resource) {
+		const json_projection::node& selection = projection.nodes[node];
+		const char begin = charAt(txt, index);
+		if (selection.whole)
+			return getParser(begin)(txt, index, resource);
+		if (begin == '{')
+			return parseProjectedObject(txt, index, projection, selection, resource);
+		if (begin == '[')
+			return parseProjectedArray(txt, index, projection, selection, resource);
+
+		index = skipValue(txt, index);
+		return json();
+	}
+
+	static json parseProjectedArray(std::string_view txt, size_t& index, const json_projection& projection, const json_projection::node& selection, std::pmr::memory_resource* resource) {
+		skipSpaces(txt, index);
+		if (charAt(txt, index) == ']')
+			return json(Array(resource));
+
+		const size_t end = selection.end();
+		elementStack<json> data;
+		for (size_t i = 0; ; i++) {
+			const uint32_t child = i < end ? selection.child(i) : 0;
+			if (child != 0) {
+				data.push(parseProjected(txt, index, projection, child, resource));
+			} else {
+				index = skipValue(txt, index);
+				if (i < end)
+					data.push(json());
+			}
+			skipSpaces(txt, index);
+
+			const char next = charAt(txt, index);
+			if (next == ']')
+				break;
+			if (next != ',')
+				throw parsingError(txt, index);
+			skipSpaces(txt, index);
+		}
+
+		return data.collect(resource);
+	}
+
+	static json parseProjectedObject(std::string_view txt, size_t& index, const json_projection& projection, const json_projection::node& selection, std::pmr::memory_resource* resource) {
+		skipSpaces(txt, index);
+		if (charAt(txt, index) == '}')
+			return json(Object(resource));
+
+		elementStack<Object::value_type> data;
+		std::string buffer;
+		while (true) {
+			if (charAt(txt, index) != '\"')
+				throw parsingError(txt, index);
+
+			const std::string_view key = readEventString(txt, index, buffer);
+			skipSpaces(txt, index);
+			if (charAt(txt, index) != ':')
+				throw parsingError(txt, index);
+			skipSpaces(txt, index);
+
+			// members only lead to a selection if it is them or they contain it
+			const uint32_t child = selection.child(key);
+			const char begin = charAt(txt, index);
+			if (child != 0 && (projection.nodes[child].whole || begin == '{' || begin == '[')) {
+				String name = makeKey(key, resource);
+				data.push({ std::move(name), parseProjected(txt, index, projection, child, resource) });
+			} else {
+				index = skipValue(txt, index);
+			}
+			skipSpaces(txt, index);
+
+			const char next = charAt(txt, index);
+			if (next == '}')
+				break;
+			if (next != ',')
+				throw parsingError(txt, index);
+			skipSpaces(txt, index);
+		}
+
+		return data.collect(resource);
+	}
+
+	//----------------------[ binding ]---------------------//
+
+	// Reads the value at index into value, which is a json_bound struct, a supported
+	// standard type or json itself. Type mismatches are reported as parsing errors.
+	template<typename T>
+	static void readBound(std::string_view txt, size_t& index, T& value) {
+		const char begin = charAt(txt, index);
+		if constexpr (std::same_as<T, json>) {
+			value = getParser(begin)(txt, index, std::pmr::get_default_resource());
+		} else if constexpr (std::same_as<T, bool>) {
+			if (begin != 't' && begin != 'f')
+				throw parsingError(txt, index);
+			value = parseBoolean(txt, index, nullptr).data.template get<Boolean>();
+		} else if constexpr (std::is_floating_point_v<T>) {
+			if (begin != '-' && !isDigit(begin))
+				throw parsingError(txt, index);
+			value = (T)(Number)parseNumber(txt, index, nullptr);
+		} else if constexpr (std::integral<T>) {
+			// integers are read straight into T, so all of its range is available
+			const char* const first = txt.data() + index;
+			const char* const last = txt.data() + txt.length();
+			const char* const digits = first + (begin == '-');
+			const char* it = digits;
+			if (it == last || !isDigit(*it))
+				throw parsingError(txt, it - txt.data());
+			while (++it != last && isDigit(*it));
+			if (*digits == '0' && it - digits > 1)
+				throw parsingError(txt, digits + 1 - txt.data());
+			if (it != last && (*it == '.' || *it == 'e' || *it == 'E'))
+				throw std::runtime_error("Expected an integer at index " + std::to_string(index));
+
+			// unsigned types only take -0 of the negative numbers
+			const std::from_chars_result result = std::from_chars(std::is_signed_v<T> ? first : digits, it, value);
+			if (result.ec != std::errc() || (std::is_unsigned_v<T> && first != digits && value != 0))
+				throw std::runtime_error("Number out of range at index " + std::to_string(index));
+			index += (it - first) - 1;
+		} else if constexpr (std::same_as<T, std::string>) {
+			if (begin != '\"')
+				throw parsingError(txt, index);
+			value.clear();
+			decodeString(txt, index, value);
+		} else if constexpr (requires { typename T::value_type; value.reset(); value.emplace(); }) {
+			// std::optional, null resets it
+			if (begin == 'n') {
+				parseNull(txt, index, nullptr);
+				value.reset();
+			} else {
+				readBound(txt, index, value.emplace());
+			}
+		} else if constexpr (json_bound<T>) {
+			readBoundObject(txt, index, value, std::make_index_sequence<std::tuple_size_v<decltype(json_fields<T>::members)>>());
+		} else if constexpr (requires { typename T::mapped_type; value[typename T::key_type(std::string_view())]; }) {
+			readBoundMap(txt, index, value);
+		} else if constexpr (requires { value.emplace_back(); value.clear(); }) {
+			readBoundArray(txt, index, value);
+		} else {
+			static_assert(sizeof(T) == 0, "type can not be read from json, specialize json_fields for it");
+		}
+	}
+
+	template<typename T>
+	static void readBoundArray(std::string_view txt, size_t& index, T& value) {
+		if (charAt(txt, index) != '[')
+			throw parsingError(txt, index);
+
+		value.clear();
+		skipSpaces(txt, index);
+		if (charAt(txt, index) == ']')
+			return;
+
+		while (true) {
+			readBound(txt, index, value.emplace_back());
+			skipSpaces(txt, index);
+
+			const char next = charAt(txt, index);
+			if (next == ']')
+				break;
+			if (next != ',')
+				throw parsingError(txt, index);
+			skipSpaces(txt, index);
+		}
+	}
+
+	// Calls f(key) with the key at index and moves index to its value.
+	template<typename F>
+	static void forEachMember(std::string_view txt, size_t& index, F&& f) {
+		if (charAt(txt, index) != '{')
+			throw parsingError(txt, index);
+
+		skipSpaces(txt, index);
+		if (charAt(txt, index) == '}')
+			return;
+
+		std::string buffer;
+		while (true) {
+			if (charAt(txt, index) != '\"')
+				throw parsingError(txt, index);
+
+			const std::string_view key = readEventString(txt, index, buffer);
+			skipSpaces(txt, index);
+			if (charAt(txt, index) != ':')
+				throw parsingError(txt, index);
+			skipSpaces(txt, index);
+
+			f(key);
+			skipSpaces(txt, index);
+
+			const char next = charAt(txt, index);
+			if (next == '}')
+				break;
+			if (next != ',')
+				throw parsingError(txt, index);
+			skipSpaces(txt, index);
+		}
+	}
+
+	template<typename T>
+	static void readBoundMap(std::string_view txt, size_t& index, T& value) {
+		value.clear();
+		forEachMember(txt, index, [&](std::string_view key) {
+			readBound(txt, index, value[typename T::key_type(key)]);
+		});
+	}
+
+	template<typename T, size_t I>
+	static void readBoundMember(std::string_view txt, size_t& index, T& value) {
+		readBound(txt, index, value.*std::get<I>(json_fields<T>::members).pointer);
+	}
+
+	// The key is looked up in json_key_table and the member read through a table
+	// with one reader per member. Members of unknown keys are skipped without being parsed.
+	template<typename T, size_t... Is>
+	static void readBoundObject(std::string_view txt, size_t& index, T& value, std::index_sequence<Is...>) {
+		typedef void (*reader)(std::string_view txt, size_t& index, T& value);
+		static constexpr reader readers[sizeof...(Is) + 1] = { &readBoundMember<T, Is>..., nullptr };
+		forEachMember(txt, index, [&](std::string_view key) {
+			const size_t member = json_key_table<T>::find(key);
+			if (member != sizeof...(Is)) {
+				readers[member](txt, index, value);
+			} else {
+				index = skipValue(txt, index);
+			}
+		});
+	}
+
+	//----------------------[ json lines ]---------------------//
+
+	// Appends the non empty lines of txt from offset on to lines until it holds count of them.
+	static void splitLines(std::string_view txt, size_t& offset, const size_t count, std::vector<std::string_view>& lines) {
+		const char* const end = txt.data() + txt.length();
+		while (lines.size() < count && offset < txt.length()) {
+			const char* const begin = txt.data() + offset;
+			const char* newline = (const char*)memchr(begin, '\n', end - begin);
+			if (newline == nullptr)
+				newline = end;
+
+			if (findNonSpace(begin, newline) != newline)
+				lines.emplace_back(begin, newline - begin);
+			offset = newline - txt.data() + 1;
+		}
+	}
+
+	// Calls f(worker, i) for all i < count on workers threads, each taking a contiguous
+	// range of i. If f throws, the exception of the smallest i is rethrown after
+	// all threads finished.
+	template<typename F>
+	static void forEachParallel(const size_t count, const size_t workers, F&& f) {
+		std::vector<std::exception_ptr> errors(workers);
+
+		const auto work = [&](const size_t worker) {
+			const size_t last = count * (worker + 1) / workers;
+			try {
+				for (size_t i = count * worker / workers; i < last; i++)
+					f(worker, i);
+			} catch (...) {
+				errors[worker] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> pool;
+		for (size_t worker = 1; worker < workers; worker++)
+			pool.emplace_back(work, worker);
+		work(0);
+		for (std::thread& thread : pool)
+			thread.join();
+
+		for (const std::exception_ptr& error : errors) {
+			if (error)
+				std::rethrow_exception(error);
+		}
+	}
+
+	static size_t workerCount(const size_t count, const unsigned threads) {
+		return std::clamp<size_t>(threads, 1, std::max<size_t>(count, 1));
+	}
+
+	// Parses lines[i] into results[i], reporting invalid lines with their line number in txt.
+	static void parseLines(std::string_view txt, std::span<const std::string_view> lines, json* results, const unsigned threads) {
+		forEachParallel(lines.size(), workerCount(lines.size(), threads), [&](size_t, const size_t i) {
+			try {
+				results[i] = parse(lines[i]);
+			} catch (const std::exception& e) {
+				const size_t number = std::count(txt.data(), lines[i].data(), '\n') + 1;
+				throw std::runtime_error("Invalid json in line " + std::to_string(number) + ": " + e.what());
+			}
+		});
+	}
+
+	//----------------------[ parallel arrays ]---------------------//
+
+	// Returns the positions of the ',' between the elements of the array starting at
+	// index, followed by that of its closing ']'. Only brackets and strings are
+	// matched here, the elements themselves are validated when they are parsed.
+	static std::vector<size_t> findElementEnds(std::string_view txt, const size_t index) {
+		const char* const begin = txt.data();
+		const char* const end = begin + txt.length();
+		const char* it = begin + index + 1;
+
+		std::vector<size_t> ends;
+		size_t depth = 1;
+		while ((it = depth == 1 ? findBracketOrQuote<true>(it, end) : findBracketOrQuote(it, end)) != end) {
+			if (*it == '\"') {
+				it = skipString(txt, it);
+			} else if (*it == ',') {
+				ends.push_back(it - begin);
+			} else if ((*it | 0x20) == '{') {
+				depth++;
+			} else if (--depth == 0) {
+				if (*it != ']')
+					throw parsingError(txt, it - begin);
+				ends.push_back(it - begin);
+				return ends;
+			}
+			it++;
+		}
+		throw parsingError(txt, txt.length());
+	}
+
+	// Parses the elements of the top level array at index in parallel, straight into their
+	// slots of the result. Worker w allocates from workerResource(w), which is called
+	// for every worker before any of them starts.
+	template<typename R>
+	static json parseArrayParallel(std::string_view txt, size_t index, const unsigned threads, std::pmr::memory_resource* resource, R&& workerResource) {
+		const std::vector<size_t> ends = findElementEnds(txt, index);
+
+		skipSpaces(txt, index);
+		if (ends.size() == 1 && index == ends.front())
+			return json(Array(resource));
+
+		Array data(ends.size(), resource);
+		json_keys* const keys = internedKeys();
+		const size_t workers = workerCount(ends.size(), threads);
+		std::vector<std::pmr::memory_resource*> resources(workers);
+		for (size_t worker = 0; worker < workers; worker++)
+			resources[worker] = workerResource(worker);
+
+		forEachParallel(ends.size(), workers, [&](const size_t worker, const size_t i) {
+			const internScope scope(keys);
+			size_t elementIndex = i == 0 ? index : ends[i - 1];
+			if (i != 0)
+				skipSpaces(txt, elementIndex);
+			data[i] = getParser(charAt(txt, elementIndex))(txt, elementIndex, resources[worker]);
+			skipSpaces(txt, elementIndex);
+			if (elementIndex != ends[i])
+				throw parsingError(txt, elementIndex);
+		});
+
+		return json(std::move(data));
+	}
+
+	//----------------------[ structural index ]---------------------//
+
+	// Character classes of a 64 byte block, bit i describes block[i].
+	struct block_masks {
+		uint64_t backslash;
+		uint64_t quote;
+		uint64_t op;
+		uint64_t space;
+	};
+
+	static block_masks classifyBlock(const char* block) {
+		block_masks masks{ 0, 0, 0, 0 };
+#if defined(JSON_SIMD_AVX2)
+		for (int i = 0; i < 64; i += 32) {
+			const __m256i chunk = _mm256_loadu_si256((const __m256i*)(block + i));
+			// '[' and ']' only differ from '{' and '}' in the 0x20 bit
+			const __m256i lowered = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+			const auto bits = [i](const __m256i matches) {
+				return (uint64_t)(uint32_t)_mm256_movemask_epi8(matches) << i;
+			};
+			masks.backslash |= bits(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+			masks.quote |= bits(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\"')));
+			masks.op |= bits(_mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(lowered, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lowered, _mm256_set1_epi8('}'))),
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')))
+			));
+			masks.space |= bits(_mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))),
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')))
+			));
+		}
+#elif defined(JSON_SIMD_SSE2)
+		for (int i = 0; i < 64; i += 16) {
+			const __m128i chunk = _mm_loadu_si128((const __m128i*)(block + i));
+			// '[' and ']' only differ from '{' and '}' in the 0x20 bit
+			const __m128i lowered = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+			const auto bits = [i](const __m128i matches) {
+				return (uint64_t)(uint32_t)_mm_movemask_epi8(matches) << i;
+			};
+			masks.backslash |= bits(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+			masks.quote |= bits(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\"')));
+			masks.op |= bits(_mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(lowered, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lowered, _mm_set1_epi8('}'))),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))
+			));
+			masks.space |= bits(_mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')))
+			));
+		}
+#else
+		for (int i = 0; i < 64; i++) {
+			const uint64_t bit = (uint64_t)1 << i;
+			switch (block[i]) {
+				case '\\':	masks.backslash |= bit; break;
+				case '\"':	masks.quote |= bit; break;
+				case '{':
+				case '}':
+				case '[':
+				case ']':
+				case ':':
+				case ',':	masks.op |= bit; break;
+				case ' ':
+				case '\n':
+				case '\t':
+				case '\r':	masks.space |= bit; break;
+			}
+		}
+#endif
+		return masks;
+	}
+
+	// Marks all characters escaped by a backslash. An escape sequence that is
+	// cut off at the end of the block is carried over to the next one.
+	static uint64_t findEscaped(uint64_t backslash, uint64_t& escapeCarry) {
+		if (backslash == 0) {
+			const uint64_t escaped = escapeCarry;
+			escapeCarry = 0;
+			return escaped;
+		}
+
+		backslash &= ~escapeCarry;
+		const uint64_t followsEscape = backslash << 1 | escapeCarry;
+
+		// runs of backslashes escape every other character, so the parity
+		// of the position a run starts on decides which characters are escaped
+		constexpr uint64_t evenBits = 0x5555555555555555ULL;
+		const uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+		const uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+		escapeCarry = sequencesStartingOnEvenBits < backslash;
+
+		const uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+		return (evenBits ^ invertMask) & followsEscape;
+	}
+
+	// Bit i of the result is the xor of the bits 0 to i, this turns
+	// the quote positions into a mask of everything inside of strings.
+	static uint64_t prefixXor(uint64_t bits) {
+#if defined(JSON_SIMD_CLMUL)
+		const __m128i product = _mm_clmulepi64_si128(
+			_mm_set_epi64x(0, bits), _mm_set1_epi8(-1), 0
+		);
+		return (uint64_t)_mm_cvtsi128_si64(product);
+#else
+		bits ^= bits << 1;
+		bits ^= bits << 2;
+		bits ^= bits << 4;
+		bits ^= bits << 8;
+		bits ^= bits << 16;
+		bits ^= bits << 32;
+		return bits;
+#endif
+	}
+
+	// Stage one: collects the positions of all operators outside of strings,
+	// of all unescaped quotes and of the first character of every other scalar,
+	// terminated by a sentinel entry pointing to the end of the input.
+	static std::vector<uint32_t> buildStructuralIndex(std::string_view txt) {
+		if (txt.length() >= UINT32_MAX)
+			throw std::length_error("Input is too large to be indexed");
+
+		std::vector<uint32_t> structurals;
+		structurals.reserve(txt.length() / 4 + 1);
+
+		uint64_t escapeCarry = 0, inStringCarry = 0, scalarCarry = 0;
+		char padded[64];
+
+		for (size_t base = 0; base < txt.length(); base += 64) {
+			const char* block = txt.data() + base;
+			if (txt.length() - base < 64) {
+				memset(padded, ' ', sizeof(padded));
+				memcpy(padded, block, txt.length() - base);
+				block = padded;
+			}
+
+			const block_masks masks = classifyBlock(block);
+			const uint64_t quote = masks.quote & ~findEscaped(masks.backslash, escapeCarry);
+			const uint64_t inString = prefixXor(quote) ^ inStringCarry;
+			inStringCarry = (uint64_t)((int64_t)inString >> 63);
+
+			const uint64_t scalar = ~(masks.op | masks.space | quote | inString);
+			const uint64_t scalarStarts = scalar & ~(scalar << 1 | scalarCarry);
+			scalarCarry = scalar >> 63;
+
+			uint64_t bits = (masks.op & ~inString) | quote | scalarStarts;
+			while (bits != 0) {
+				structurals.push_back((uint32_t)(base + std::countr_zero(bits)));
+				bits &= bits - 1;
+			}
+		}
+
+		if (inStringCarry != 0)
+			throw std::runtime_error("Invalid json (unterminated string)");
+
+		structurals.push_back((uint32_t)txt.length());
+		return structurals;
+	}
+
+	// The index does not split scalars further, so only whitespace
+	// may lie between the end of one and the next structural character.
+	static void expectStructuralAfter(std::string_view txt, const size_t index, const size_t next) {
+		const char* const it = findNonSpace(txt.data() + index + 1, txt.data() + txt.length());
+		if (it != txt.data() + next)
+			throw parsingError(txt, it - txt.data());
+	}
+
+	// Stage two: every function consumes the index entries of its value.
+	// Reading past the sentinel is impossible, as '\0' is rejected as soon
+	// as the sentinel itself is consumed.
+	template<bool KEY = false>
+	static String readIndexedString(std::string_view txt, size_t index, const uint32_t*& structural, std::pmr::memory_resource* resource) {
+		// the closing quote is the next entry and has to be where readString stops
+		const size_t end = *structural++;
+		String data = KEY ? readKey(txt, index, resource) : readString(txt, index, resource);
+		if (index != end)
+			throw parsingError(txt, index);
+
+		expectStructuralAfter(txt, end, *structural);
+		return data;
+	}
+
+	static json parseIndexedValue(std::string_view txt, const uint32_t*& structural, std::pmr::memory_resource* resource) {
+		size_t index = *structural++;
+		switch (charAt(txt, index)) {
+			case '{': return parseIndexedObject(txt, structural, resource);
+			case '[': return parseIndexedArray(txt, structural, resource);
+			case '\"': return json(readIndexedString(txt, index, structural, resource));
+			default: {
+				json value = getParser(charAt(txt, index))(txt, index, resource);
+				expectStructuralAfter(txt, index, *structural);
+				return value;
+			}
+		}
+	}
+
+	static json parseIndexedArray(std::string_view txt, const uint32_t*& structural, std::pmr::memory_resource* resource) {
+		if (charAt(txt, *structural) == ']') {
+			structural++;
+			return json(Array(resource));
+		}
+
+		elementStack<json> data;
+		while (true) {
+			data.push(parseIndexedValue(txt, structural, resource));
+
+			const size_t next = *structural++;
+			if (charAt(txt, next) == ']')
+				break;
+			if (charAt(txt, next) != ',')
+				throw parsingError(txt, next);
+		}
+
+		return data.collect(resource);
+	}
+
+	static json parseIndexedObject(std::string_view txt, const uint32_t*& structural, std::pmr::memory_resource* resource) {
+		if (charAt(txt, *structural) == '}') {
+			structural++;
+			return json(Object(resource));
+		}
+
+		elementStack<Object::value_type> data;
+		while (true) {
+			const size_t index = *structural++;
+			if (charAt(txt, index) != '\"')
+				throw parsingError(txt, index);
+
+			String name = readIndexedString<true>(txt, index, structural, resource);
+			if (charAt(txt, *structural) != ':')
+				throw parsingError(txt, *structural);
+			structural++;
+
+			data.push({ std::move(name), parseIndexedValue(txt, structural, resource) });
+
+			const size_t next = *structural++;
+			if (charAt(txt, next) == '}')
+				break;
+			if (charAt(txt, next) != ',')
+				throw parsingError(txt, next);
+		}
+
+		return data.collect(resource);
+	}
+
+	static const std::runtime_error parsingError(std::string_view txt, const size_t index) {
+		using std::operator""s;
+		return std::runtime_error(
+			"Invalid symbole '"s + charAt(txt, index) + "' at index "s +
+			std::to_string(index) + '\''
+		);
+	}
+
+	static const std::runtime_error parsingError(std::string_view txt, const json_error error) {
+		if (error.code == json_errc::number_out_of_range || error.code == json_errc::depth_exceeded)
+			return std::runtime_error(std::string(error.message()) + " at index " + std::to_string(error.offset));
+		return parsingError(txt, error.offset);
+	}
+
+public:
+	//----------------------[ accesors ]---------------------//
+
+	const json& operator[](const size_t index) const {
+		return data.get<Array>()[index];
+	}
+
+	json& operator[](const size_t index) {
+		return data.get<Array>()[index];
+	}
+
+
+	const json& operator[](const char* s) const { return data.get<Object>().at(s); }
+	const json& operator[](const std::string& s) const { return data.get<Object>().at(s); }
+
+	json& operator[](const char* s) { return data.get<Object>()[s]; }
+	json& operator[](const std::string& s) { return data.get<Object>()[s]; }
+
+	json_type getType() const { return data.type; };
+
+	// Returns nullptr instead of throwing if the value is not a T,
+	// integers are not converted to Number here.
+	template<json_data_type T>
+	const T* try_get() const noexcept {
+		return data.try_get<T>();
+	}
+
+	template<json_data_type T>
+	T* try_get() noexcept {
+		return data.try_get<T>();
+	}
+
+	size_t size() const {
+		switch (data.type) {
+			using enum json_type;
+			case array:		return data.get<Array>().size();
+			case object:	return data.get<Object>().size();
+			default: data.get<Array>(); // throws access error
+		}
+		return 0;
+	}
+
+	size_t length() const {
+		return data.get<String>().length();
+	}
+
+	//----------------------[ to_string ]---------------------//
+	
+	friend std::ostream & operator<<(std::ostream&, const json&);
+
+	// Writes the text to out in one piece, see dump for the meaning of indent.
+	void to_string(std::ostream& out, int indent = -1) const {
+		std::string buffer;
+		dump(buffer, indent);
+		out.write(buffer.data(), buffer.length());
+	}
+
+	// Appends the text to sink. A negative indent writes it in one line, otherwise
+	// nested values are put on separate lines and indented by indent + depth tabs.
+	template<typename S> requires json_sink<std::remove_cvref_t<S>>
+	void dump(S&& sink, int indent = -1) const {
+		writer<std::remove_cvref_t<S>> out{ sink };
+		write(out, indent);
+	}
+
+	std::string dump(int indent = -1) const {
+		std::string buffer;
+		dump(buffer, indent);
+		return buffer;
+	}
+
+	// Appends the text of value to sink in the compact form of dump, without building
+	// json nodes. T is anything parse_as reads, or any other range of such values.
+	// The keys of json_bound structs are escaped at compile time.
+	template<typename S, typename T> requires json_sink<std::remove_cvref_t<S>>
+	static void write(S&& sink, const T& value) {
+		writer<std::remove_cvref_t<S>> out{ sink };
+		writeBound(out, value);
+	}
+
+	template<typename T>
+	static std::string write(const T& value) {
+		std::string buffer;
+		write(buffer, value);
+		return buffer;
+	}
+
+private:
+	template<typename S>
+	struct writer {
+		S& sink;
+		std::string tabs{};
+
+		void put(const char* data, const size_t length) {
+			if constexpr (requires { sink.append(data, length); }) {
+				sink.append(data, length);
+			} else {
+				sink = std::copy(data, data + length, sink);
+			}
+		}
+
+		void put(std::string_view text) {
+			put(text.data(), text.length());
+		}
+
+		void put(const char c) {
+			put(&c, 1);
+		}
+
+		// the tabs are shared by all levels, so indenting is a single append
+		void putTabs(const size_t count) {
+			if (tabs.length() < count)
+				tabs.resize(std::max(count, 2 * tabs.length()), '\t');
+			put(tabs.data(), count);
+		}
+	};
+
+	// Writes the shortest text that parses back to the same double.
+	// json has no representation for infinity and NaN, they are written as null.
+	template<typename S>
+	static void writeNumber(writer<S>& out, const Number value) {
+		char buffer[32];
+		char* end;
+
+		// integral values (except -0) are formatted as integers, which skips the digit search,
+		// all numbers without fraction or exponent get ".0" so they are read back as Number
+		constexpr Number maxExact = (Number)(uint64_t(1) << std::numeric_limits<Number>::digits);
+		if (value >= -maxExact && value <= maxExact && (Number)(int64_t)value == value && (value != 0 || !std::signbit(value))) {
+			end = std::to_chars(buffer, buffer + sizeof(buffer), (int64_t)value).ptr;
+		} else if (std::isfinite(value)) {
+			end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+		} else {
+			out.put("null");
+			return;
+		}
+		if (std::find_if(buffer, end, [](const char c) { return c == '.' || c == 'e'; }) == end) {
+			*end++ = '.';
+			*end++ = '0';
+		}
+		out.put(buffer, end - buffer);
+	}
+
+	// Writes the quoted string, the vectorized scan of the parser finds the characters
+	// that need escaping and everything between them is copied in one piece.
+	template<typename S>
+	static void writeString(writer<S>& out, std::string_view text) {
+		const char* it = text.data();
+		const char* const end = it + text.length();
+
+		out.put('\"');
+		while (true) {
+			const char* const run = it;
+			it = findStringSpecial(it, end);
+			out.put(run, it - run);
+			if (it == end)
+				break;
+
+			switch (*it) {
+				case '\"':	out.put("\\\""); break;
+				case '\\':	out.put("\\\\"); break;
+				case '\b':	out.put("\\b"); break;
+				case '\f':	out.put("\\f"); break;
+				case '\n':	out.put("\\n"); break;
+				case '\r':	out.put("\\r"); break;
+				case '\t':	out.put("\\t"); break;
+				default: {
+					constexpr char hex[] = "0123456789abcdef";
+					const char escape[] = { '\\', 'u', '0', '0', hex[*it >> 4], hex[*it & 0xF] };
+					out.put(escape, sizeof(escape));
+				}
+			}
+			it++;
+		}
+		out.put('\"');
+	}
+
+	template<typename S, typename T>
+	static void writeBound(writer<S>& out, const T& value) {
+		if constexpr (std::same_as<T, json>) {
+			value.write(out, -1);
+		} else if constexpr (std::same_as<T, bool>) {
+			out.put(value ? std::string_view("true") : std::string_view("false"));
+		} else if constexpr (std::integral<T>) {
+			char buffer[24];
+			out.put(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+		} else if constexpr (std::floating_point<T>) {
+			writeNumber(out, (Number)value);
+		} else if constexpr (std::convertible_to<const T&, std::string_view>) {
+			writeString(out, value);
+		} else if constexpr (requires { value.has_value(); *value; }) {
+			if (value.has_value()) {
+				writeBound(out, *value);
+			} else {
+				out.put("null");
+			}
+		} else if constexpr (json_bound<T>) {
+			out.put('{');
+			[&]<size_t... Is>(std::index_sequence<Is...>) {
+				constexpr auto& members = json_fields<T>::members;
+				((out.put(json_key_text<T, Is>.data(), json_key_text<T, Is>.size()), writeBound(out, value.*std::get<Is>(members).pointer)), ...);
+			}(std::make_index_sequence<std::tuple_size_v<decltype(json_fields<T>::members)>>());
+			out.put('}');
+		} else if constexpr (requires { typename T::mapped_type; value.begin()->first; value.begin()->second; }) {
+			out.put('{');
+			for (auto it = value.begin(); it != value.end(); it++) {
+				if (it != value.begin())
+					out.put(',');
+				writeString(out, it->first);
+				out.put(": ");
+				writeBound(out, it->second);
+			}
+			out.put('}');
+		} else if constexpr (requires { value.begin(); value.end(); }) {
+			out.put('[');
+			for (auto it = value.begin(); it != value.end(); it++) {
+				if (it != value.begin())
+					out.put(',');
+				writeBound(out, *it);
+			}
+			out.put(']');
+		} else {
+			static_assert(sizeof(T) == 0, "type can not be written as json, specialize json_fields for it");
+		}
+	}
+
+	template<typename S>
+	void write(writer<S>& out, int indent) const {
+		using enum json_type;
+
+		if (data.type == null) {
+			out.put("null");
+		} else if (data.type == boolean) {
+			out.put(data.get<Boolean>() ? std::string_view("true") : std::string_view("false"));
+		} else if (data.type == number) {
+			writeNumber(out, data.get<Number>());
+		} else if (data.type == integer) {
+			char buffer[24];
+			out.put(buffer, std::to_chars(buffer, buffer + sizeof(buffer), data.get<Integer>()).ptr - buffer);
+		} else if (data.type == unsigned_integer) {
+			char buffer[24];
+			out.put(buffer, std::to_chars(buffer, buffer + sizeof(buffer), data.get<Unsigned>()).ptr - buffer);
+		} else if (data.type == string) {
+			writeString(out, data.get<String>());
+		} else {
+			const bool pretty = indent >= 0;
+			if (pretty)
+				indent++;
+
+			if (data.type == array) {
+				out.put(pretty ? std::string_view("[\n") : std::string_view("["));
+				auto it = data.get<Array>().begin();
+				const auto end = data.get<Array>().end();
+				while (it != end) {
+					if (pretty)
+						out.putTabs(indent);
+					it->write(out, indent);
+					if (++it != end)
+						out.put(',');
+					if (pretty)
+						out.put('\n');
+				}
+				if (pretty)
+					out.putTabs(indent - 1);
+				out.put(']');
+			} else if (data.type == object) {
+				out.put(pretty ? std::string_view("{\n") : std::string_view("{"));
+				auto it = data.get<Object>().begin();
+				const auto end = data.get<Object>().end();
+				while (it != end) {
+					if (pretty)
+						out.putTabs(indent);
+					writeString(out, it->first);
+					out.put(": ");
+					it->second.write(out, indent);
+					if (++it != end)
+						out.put(',');
+					if (pretty)
+						out.put('\n');
+				}
+				if (pretty)
+					out.putTabs(indent - 1);
+				out.put('}');
+			}
+		}
+	}
+
+public:
+
+	//----------------------[ assignemt ]---------------------//
+
+	template<json_data_type T> requires (!std::same_as<T, Unsigned>)
+	json& operator=(const T& t) {
+		data = t;
+		return *this;
+	}
+
+	template<json_data_type T> requires (!std::same_as<T, Unsigned>)
+	json& operator=(T&& t) {
+		data = std::move(t);
+		return *this;
+	}
+
+	json& operator=(const json& otherJSON) {
+		data = std::move(copy_json_data(otherJSON.data));
+		return *this;
+	}
+
+	json& operator=(json&& otherJSON) noexcept {
+		data = std::move(otherJSON.data);
+		return *this;
+	}
+	
+	//----------------------[ casts ]---------------------//
+	
+	// Number is read by value, so that integers can be converted to it
+	template<json_data_type T> requires (!std::same_as<T, Number>)
+	operator const T() const {
+		return data.get<T>();
+	}
+
+	template<json_data_type T> requires (!std::same_as<T, Number>)
+	operator const T&() const {
+		return data.get<T>();
+	}
+
+	template<json_data_type T> requires (!std::same_as<T, Number>)
+	operator T&() {
+		return data.get<T>();
+	}
+
+	operator Number() const {
+		switch (data.type) {
+			case json_type::integer:			return (Number)data.get<Integer>();
+			case json_type::unsigned_integer:	return (Number)data.get<Unsigned>();
+			default:							return data.get<Number>();
+		}
+	}
+
+	operator std::string() const {
+		const String& s = data.get<String>();
+		return std::string(s.data(), s.length());
+	}
+
+	operator std::string_view() const {
+		return data.get<String>();
+	}
+};
+
+// Owns the memory of documents parsed or built in it. All nodes are bump
+// allocated from a monotonic buffer in creation order, and destroying the
+// arena releases the whole document at once without visiting its nodes.
+// Values added to such a document have to be allocated from resource() as well.
+class json_arena {
+private:
+	std::pmr::monotonic_buffer_resource buffer;
+	std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> workerBuffers;
+
+public:
+	json_arena() = default;
+
+	explicit json_arena(const size_t initialSize) : buffer(initialSize) {}
+
+	json_arena(const json_arena&) = delete;
+	json_arena& operator=(const json_arena&) = delete;
+
+	std::pmr::memory_resource* resource() {
+		return &buffer;
+	}
+
+	// The returned json is never destructed and stays valid as long as the arena.
+	json& create(json&& value = json()) {
+		return *new (buffer.allocate(sizeof(json), alignof(json))) json(std::move(value));
+	}
+
+	json& parse(std::string_view txt) {
+		return create(json::parse(txt, &buffer));
+	}
+
+	json& parse_fast(std::string_view txt) {
+		return create(json::parse_fast(txt, &buffer));
+	}
+
+	// Like json::parse_parallel, every thread allocates from its own buffer of the arena.
+	json& parse_parallel(std::string_view txt, const unsigned threads = std::thread::hardware_concurrency()) {
+		size_t index = 0;
+		if (!txt.empty() && json::isSpace(txt[0]))
+			json::skipSpaces(txt, index);
+
+		if (json::charAt(txt, index) != '[')
+			return parse(txt);
+
+		return create(json::parseArrayParallel(txt, index, threads, &buffer, [this](size_t) {
+			return workerBuffers.emplace_back(std::make_unique<std::pmr::monotonic_buffer_resource>()).get();
+		}));
+	}
+};
+
+// Read only document that stores the whole parse result in a single allocation:
+// a tape of tagged 64 bit words in document order, followed by the string data.
+// Every word holds the json_type in its top byte and a payload below it:
+//   null, boolean	one word, the payload of booleans is 0 or 1
+//   number, integer,
+//   unsigned_integer	two words, the second one holds the bits of the double, int64 or uint64
+//   string			one word, the payload is the offset of the string data,
+//					which is stored as a 32 bit length, the characters and a '\0'
+//   array, object	two words, the payload is the number of words the container
+//					spans and the second word its size, followed by the elements
+//					(objects alternate key strings and values)
+// Walking the tape is sequential, but indexing an array or looking up
+// a key has to skip over all preceding elements. Members are kept as written,
+// so duplicate keys count towards size() while lookups find the first one.
+class json_tape {
+public:
+	typedef json::json_type json_type;
+
+	// Non owning view of a value on the tape, valid as long as its json_tape.
+	class value {
+	private:
+		const uint64_t* word;
+		const char* strings;
+
+		uint64_t payload() const {
+			return *word & payloadMask;
+		}
+
+		void expect(const json_type type) const {
+			if (getType() != type) {
+				std::string message("Tried to access ");
+				message += json::typeToString(type);
+				message += " but dynamic type was ";
+				message += json::typeToString(getType());
+				throw std::invalid_argument(message);
+			}
+		}
+
+		// Returns the word after the value starting at word.
+		static const uint64_t* skip(const uint64_t* word) {
+			switch ((json_type)(*word >> tagShift)) {
+				using enum json_type;
+				case number:
+				case integer:
+				case unsigned_integer:	return word + 2;
+				case array:
+				case object:	return word + (*word & payloadMask);
+				default:		return word + 1;
+			}
+		}
+
+	public:
+		value(const uint64_t* word, const char* strings) : word(word), strings(strings) {}
+
+		//----------------------[ accesors ]---------------------//
+
+		json_type getType() const {
+			return (json_type)(*word >> tagShift);
+		}
+
+		size_t size() const {
+			if (getType() != json_type::object)
+				expect(json_type::array);
+			return word[1];
+		}
+
+		size_t length() const {
+			return std::string_view(*this).length();
+		}
+
+		value operator[](const size_t index) const {
+			expect(json_type::array);
+			if (index >= size())
+				throw std::out_of_range("Array index out of range");
+
+			const uint64_t* element = word + 2;
+			for (size_t i = 0; i < index; i++)
+				element = skip(element);
+			return value(element, strings);
+		}
+
+		// Returns the value of the first member named key.
+		value operator[](std::string_view key) const {
+			expect(json_type::object);
+
+			const uint64_t* const end = skip(word);
+			for (const uint64_t* member = word + 2; member != end; member = skip(member + 1)) {
+				if (std::string_view(value(member, strings)) == key)
+					return value(member + 1, strings);
+			}
+			throw std::out_of_range("Unknown key");
+		}
+
+		value operator[](const char* key) const {
+			return (*this)[std::string_view(key)];
+		}
+
+		//----------------------[ casts ]---------------------//
+
+		operator Boolean() const {
+			expect(json_type::boolean);
+			return payload() != 0;
+		}
+
+		operator Number() const {
+			if (getType() == json_type::integer)
+				return (Number)std::bit_cast<Integer>(word[1]);
+			if (getType() == json_type::unsigned_integer)
+				return (Number)word[1];
+			expect(json_type::number);
+			return std::bit_cast<Number>(word[1]);
+		}
+
+		operator Integer() const {
+			expect(json_type::integer);
+			return std::bit_cast<Integer>(word[1]);
+		}
+
+		operator Unsigned() const {
+			expect(json_type::unsigned_integer);
+			return word[1];
+		}
+
+		operator std::string_view() const {
+			expect(json_type::string);
+			const char* const data = strings + payload();
+			uint32_t length;
+			memcpy(&length, data, sizeof(length));
+			return std::string_view(data + sizeof(length), length);
+		}
+
+		operator std::string() const {
+			return std::string(std::string_view(*this));
+		}
+	};
+
+private:
+	static constexpr int tagShift = 56;
+	static constexpr uint64_t payloadMask = (uint64_t(1) << tagShift) - 1;
+
+	std::unique_ptr<uint64_t[]> buffer;
+	const char* strings = nullptr;
+
+	static uint64_t makeWord(const json_type type, const uint64_t payload) {
+		return (uint64_t)type << tagShift | payload;
+	}
+
+	// Fills the tape while walking the structural index, following the
+	// same grammar as json::parseIndexedValue.
+	struct builder {
+		std::string_view txt;
+		const uint32_t* structural;
+		uint64_t* word;
+		char* const strings;
+		char* string;
+
+		// decodeString output writing directly into the string data
+		struct stringWriter {
+			char* it;
+
+			void operator+=(const char c) {
+				*it++ = c;
+			}
+
+			void append(const char* first, const char* last) {
+				memcpy(it, first, last - first);
+				it += last - first;
+			}
+		};
+
+		void parseString(size_t index) {
+			const size_t end = *structural++;
+			stringWriter data{ string + sizeof(uint32_t) };
+			json::decodeString(txt, index, data);
+			if (index != end)
+				throw json::parsingError(txt, index);
+			json::expectStructuralAfter(txt, end, *structural);
+
+			const uint32_t length = (uint32_t)(data.it - string - sizeof(uint32_t));
+			memcpy(string, &length, sizeof(length));
+			*data.it = '\0';
+			*word++ = makeWord(json_type::string, string - strings);
+			string = data.it + 1;
+		}
+
+		void parseValue() {
+			size_t index = *structural++;
+			switch (json::charAt(txt, index)) {
+				case '{': parseObject(); break;
+				case '[': parseArray(); break;
+				case '\"': parseString(index); break;
+				default: {
+					const json value = json::getParser(json::charAt(txt, index))(txt, index, std::pmr::null_memory_resource());
+					json::expectStructuralAfter(txt, index, *structural);
+
+					if (value.getType() == json_type::number) {
+						*word++ = makeWord(json_type::number, 0);
+						*word++ = std::bit_cast<uint64_t>(value.data.get<Number>());
+					} else if (value.getType() == json_type::integer) {
+						*word++ = makeWord(json_type::integer, 0);
+						*word++ = std::bit_cast<uint64_t>(value.data.get<Integer>());
+					} else if (value.getType() == json_type::unsigned_integer) {
+						*word++ = makeWord(json_type::unsigned_integer, 0);
+						*word++ = value.data.get<Unsigned>();
+					} else if (value.getType() == json_type::boolean) {
+						*word++ = makeWord(json_type::boolean, value.data.get<Boolean>());
+					} else {
+						*word++ = makeWord(json_type::null, 0);
+					}
+				}
+			}
+		}
+
+		void parseArray() {
+			uint64_t* const header = word;
+			word += 2;
+
+			size_t count = 0;
+			if (json::charAt(txt, *structural) == ']') {
+				structural++;
+			} else while (true) {
+				parseValue();
+				count++;
+
+				const size_t next = *structural++;
+				if (json::charAt(txt, next) == ']')
+					break;
+				if (json::charAt(txt, next) != ',')
+					throw json::parsingError(txt, next);
+			}
+
+			header[0] = makeWord(json_type::array, word - header);
+			header[1] = count;
+		}
+
+		void parseObject() {
+			uint64_t* const header = word;
+			word += 2;
+
+			size_t count = 0;
+			if (json::charAt(txt, *structural) == '}') {
+				structural++;
+			} else while (true) {
+				const size_t index = *structural++;
+				if (json::charAt(txt, index) != '\"')
+					throw json::parsingError(txt, index);
+
+				parseString(index);
+				if (json::charAt(txt, *structural) != ':')
+					throw json::parsingError(txt, *structural);
+				structural++;
+
+				parseValue();
+				count++;
+
+				const size_t next = *structural++;
+				if (json::charAt(txt, next) == '}')
+					break;
+				if (json::charAt(txt, next) != ',')
+					throw json::parsingError(txt, next);
+			}
+
+			header[0] = makeWord(json_type::object, word - header);
+			header[1] = count;
+		}
+	};
+
+public:
+	json_tape() = default;
+
+	static json_tape parse(std::string_view txt) {
+		const std::vector<uint32_t> structurals = json::buildStructuralIndex(txt);
+
+		const char begin = json::charAt(txt, structurals.front());
+		if (begin != '{' && begin != '[')
+			throw std::runtime_error("Invalid json");
+
+		// Every structural character produces a known number of words, and decoded
+		// strings are never longer than their source, so the buffer is sized up front.
+		size_t words = 0, stringBytes = txt.length();
+		for (auto it = structurals.begin(); it != structurals.end() - 1; it++) {
+			switch (txt[*it]) {
+				case '{':
+				case '[':	words += 2; break;
+				case '\"':	words += 1; stringBytes += sizeof(uint32_t) + 1; break;
+				case '}':
+				case ']':
+				case ',':
+				case ':':	break;
+				case 't':
+				case 'f':
+				case 'n':	words += 1; break;
+				default:	words += 2;
+			}
+		}
+
+		json_tape document;
+		document.buffer = std::make_unique_for_overwrite<uint64_t[]>(words + (stringBytes + 7) / 8);
+		char* const strings = (char*)(document.buffer.get() + words);
+		document.strings = strings;
+
+		builder tape{ txt, structurals.data(), document.buffer.get(), strings, strings };
+		tape.parseValue();
+
+		return document;
+	}
+
+	static json_tape parse(const std::string& txt) {
+		return parse(std::string_view(txt));
+	}
+
+	static json_tape parse(const char* txt) {
+		return parse(std::string_view(txt));
+	}
+
+	static json_tape parse(const char* txt, const size_t length) {
+		return parse(std::string_view(txt, length));
+	}
+
+	static json_tape parse(std::span<const char> txt) {
+		return parse(std::string_view(txt.data(), txt.size()));
+	}
+
+	//----------------------[ accesors ]---------------------//
+
+	value root() const {
+		return value(buffer.get(), strings);
+	}
+
+	value operator[](const size_t index) const { return root()[index]; }
+	value operator[](std::string_view key) const { return root()[key]; }
+	value operator[](const char* key) const { return root()[key]; }
+
+	json_type getType() const { return root().getType(); }
+
+	size_t size() const { return root().size(); }
+};
+
+// On demand view of a json text that decodes nothing until it is converted.
+// Indexing moves to the requested child by matching quotes and brackets of the
+// siblings in front of it, which are neither allocated nor validated, and
+// only the accessed values are parsed by the casts. The text has to outlive
+// every cursor into it.
+class json_cursor {
+public:
+	typedef json::json_type json_type;
+
+private:
+	std::string_view txt;
+	size_t index;
+
+	json_cursor(std::string_view txt, const size_t index) : txt(txt), index(index) {}
+
+	void expect(const json_type type) const {
+		if (getType() != type) {
+			std::string message("Tried to access ");
+			message += json::typeToString(type);
+			message += " but dynamic type was ";
+			message += json::typeToString(getType());
+			throw std::invalid_argument(message);
+		}
+	}
+
+	// Moves from the value at index past the following ',' to the next element,
+	// returns false if the container ends with close instead.
+	bool nextElement(size_t& position, const char close) const {
+		position = json::skipValue(txt, position);
+		json::skipSpaces(txt, position);
+		const char next = json::charAt(txt, position);
+		if (next == close)
+			return false;
+		if (next != ',')
+			throw json::parsingError(txt, position);
+		json::skipSpaces(txt, position);
+		return true;
+	}
+
+	// Moves from the key at position to its value.
+	void skipKey(size_t& position) const {
+		if (json::charAt(txt, position) != '\"')
+			throw json::parsingError(txt, position);
+		position = json::skipString(txt, txt.data() + position) - txt.data();
+		json::skipSpaces(txt, position);
+		if (json::charAt(txt, position) != ':')
+			throw json::parsingError(txt, position);
+		json::skipSpaces(txt, position);
+	}
+
+	// Keys are compared in their raw form unless they contain escapes.
+	bool keyEquals(const size_t position, std::string_view key) const {
+		const char* const begin = txt.data() + position + 1;
+		const char* const end = json::skipString(txt, txt.data() + position);
+		const std::string_view raw(begin, end - begin);
+		if (raw.find('\\') == std::string_view::npos)
+			return raw == key;
+
+		size_t stringIndex = position;
+		std::string decoded;
+		json::decodeString(txt, stringIndex, decoded);
+		return decoded == key;
+	}
+
+public:
+	explicit json_cursor(std::string_view txt) : txt(txt), index(0) {
+		if (!txt.empty() && json::isSpace(txt[0]))
+			json::skipSpaces(txt, index);
+	}
+
+	//----------------------[ accesors ]---------------------//
+
+	json_type getType() const {
+		switch (json::charAt(txt, index)) {
+			using enum json_type;
+			case '{':			return object;
+			case '[':			return array;
+			case '\"':			return string;
+			case 't':
+			case 'f':			return boolean;
+			case 'n':			return null;
+			case '-':
+			case '0' ... '9': {
+				// whether it is an integer depends on the whole number
+				size_t position = index;
+				return json::parseNumber(txt, position, nullptr).getType();
+			}
+			default: throw json::parsingError(txt, index);
+		}
+	}
+
+	json_cursor operator[](const size_t elementIndex) const {
+		expect(json_type::array);
+
+		size_t position = index;
+		json::skipSpaces(txt, position);
+		if (json::charAt(txt, position) == ']')
+			throw std::out_of_range("Array index out of range");
+
+		for (size_t i = 0; i < elementIndex; i++) {
+			if (!nextElement(position, ']'))
+				throw std::out_of_range("Array index out of range");
+		}
+		return json_cursor(txt, position);
+	}
+
+	// Returns the value of the first member named key.
+	json_cursor operator[](std::string_view key) const {
+		expect(json_type::object);
+
+		size_t position = index;
+		json::skipSpaces(txt, position);
+		if (json::charAt(txt, position) != '}') {
+			do {
+				const bool matches = json::charAt(txt, position) == '\"' && keyEquals(position, key);
+				skipKey(position);
+				if (matches)
+					return json_cursor(txt, position);
+			} while (nextElement(position, '}'));
+		}
+		throw std::out_of_range("Unknown key");
+	}
+
+	json_cursor operator[](const char* key) const {
+		return (*this)[std::string_view(key)];
+	}
+
+	// Counts the elements or members, which skips over all of them.
+	size_t size() const {
+		const json_type type = getType();
+		if (type != json_type::object)
+			expect(json_type::array);
+
+		const char close = type == json_type::array ? ']' : '}';
+		size_t position = index;
+		json::skipSpaces(txt, position);
+		if (json::charAt(txt, position) == close)
+			return 0;
+
+		size_t count = 0;
+		do {
+			if (type == json_type::object)
+				skipKey(position);
+			count++;
+		} while (nextElement(position, close));
+		return count;
+	}
+
+	size_t length() const {
+		return std::string(*this).length();
+	}
+
+	//----------------------[ casts ]---------------------//
+
+	operator Boolean() const {
+		expect(json_type::boolean);
+		size_t position = index;
+		return json::parseBoolean(txt, position, nullptr).data.get<Boolean>();
+	}
+
+	operator Number() const {
+		const json_type type = getType();
+		if (type != json_type::integer && type != json_type::unsigned_integer)
+			expect(json_type::number);
+		size_t position = index;
+		return json::parseNumber(txt, position, nullptr);
+	}
+
+	operator Integer() const {
+		expect(json_type::integer);
+		size_t position = index;
+		return json::parseNumber(txt, position, nullptr).data.get<Integer>();
+	}
+
+	operator Unsigned() const {
+		expect(json_type::unsigned_integer);
+		size_t position = index;
+		return json::parseNumber(txt, position, nullptr).data.get<Unsigned>();
+	}
+
+	operator std::string() const {
+		expect(json_type::string);
+		size_t position = index;
+		std::string data;
+		json::decodeString(txt, position, data);
+		return data;
+	}
+
+	// Parses the whole value at the cursor.
+	json materialize(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const {
+		size_t position = index;
+		return json::getParser(json::charAt(txt, position))(txt, position, resource);
+	}
+
+	operator json() const {
+		return materialize();
+	}
+};
+
+// Push parser for json values that arrive in chunks, e.g. from a socket.
+// Chunks are appended to an internal buffer and scanned once for the end of
+// the current top level value, keeping the string and nesting state between
+// calls. Once it is complete, take() parses exactly that value with json::parse;
+// bytes following it stay buffered as the beginning of the next one.
+// feed throws if a value starts with anything but '{' or '[', the stream
+// cannot be resynchronized after that.
+class json_push_parser {
+public:
+	enum class status {
+		need_more,
+		value_complete
+	};
+
+private:
+	std::pmr::memory_resource* resource;
+	std::string buffer;
+	size_t offset = 0;		// bytes of buffer that have been taken
+	size_t scanned = 0;		// bytes of buffer that have been looked at
+	size_t end = 0;			// end of the complete value in buffer, 0 while there is none
+	size_t depth = 0;
+	bool inString = false;
+	bool escaped = false;
+
+	status scan() {
+		if (end != 0)
+			return status::value_complete;
+
+		const char* const begin = buffer.data();
+		const char* const last = begin + buffer.length();
+		const char* it = begin + scanned;
+
+		while (it != last) {
+			if (escaped) {
+				escaped = false;
+				it++;
+			} else if (inString) {
+				// anything else the string contains is left for the parser to reject
+				it = json::findStringSpecial(it, last);
+				if (it == last)
+					break;
+				if (*it == '\"') {
+					inString = false;
+				} else if (*it == '\\') {
+					escaped = true;
+				}
+				it++;
+			} else if (depth == 0) {
+				it = json::findNonSpace(it, last);
+				if (it == last)
+					break;
+				if (*it != '{' && *it != '[')
+					throw json::parsingError(std::string_view(buffer).substr(offset), it - begin - offset);
+				depth = 1;
+				it++;
+			} else {
+				it = json::findBracketOrQuote(it, last);
+				if (it == last)
+					break;
+				if (*it == '\"') {
+					inString = true;
+				} else if ((*it | 0x20) == '{') {
+					depth++;
+				} else if (--depth == 0) {
+					end = scanned = it + 1 - begin;
+					return status::value_complete;
+				}
+				it++;
+			}
+		}
+
+		scanned = it - begin;
+		return status::need_more;
+	}
+
+public:
+	explicit json_push_parser(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : resource(resource) {}
+
+	// Appends chunk and reports whether a complete value is buffered.
+	// An empty chunk checks the bytes left over from the previous value.
+	status feed(std::span<const char> chunk) {
+		buffer.append(chunk.data(), chunk.size());
+		return scan();
+	}
+
+	// Parses the complete value and removes it from the buffer,
+	// which happens as well if the value turns out to be invalid.
+	// Taken bytes are only moved out of the buffer once they are more than
+	// half of it, so draining a chunk of many values stays linear.
+	json take() {
+		if (end == 0)
+			throw std::logic_error("No complete json value to take");
+
+		struct consume {
+			json_push_parser& parser;
+			~consume() {
+				parser.offset = parser.end;
+				parser.end = 0;
+				if (parser.offset == parser.buffer.length()) {
+					parser.buffer.clear();
+					parser.offset = parser.scanned = 0;
+				} else if (parser.offset > parser.buffer.length() / 2) {
+					parser.buffer.erase(0, parser.offset);
+					parser.scanned -= parser.offset;
+					parser.offset = 0;
+				}
+			}
+		} guard{ *this };
+
+		return json::parse(std::string_view(buffer).substr(offset, end - offset), resource);
+	}
+
+	// Bytes received but not yet taken.
+	size_t buffered() const {
+		return buffer.length() - offset;
+	}
+};
+
+// Path into a json document, compiled once from a json pointer (RFC 6901) like "/a/b/3/c"
+// or from a JSONPath of names and indices like "$.a['b'][3].c". Every token is kept
+// with its key hash and, if it is a number, the array index it stands for, so
+// following it neither builds strings nor hashes keys. find returns nullptr
+// instead of throwing when the path does not exist.
+class json_path {
+	friend class json_paths;
+
+private:
+	struct step {
+		std::string key;
+		uint32_t hash;
+		size_t index;	// SIZE_MAX if key is not an array index
+
+		friend bool operator==(const step& a, const step& b) { return a.key == b.key; }
+		friend auto operator<=>(const step& a, const step& b) { return a.key <=> b.key; }
+	};
+
+	std::vector<step> steps;
+
+	void addStep(std::string&& key) {
+		size_t index;
+		if (!json_pointer::isIndex(key, index))
+			index = SIZE_MAX;
+		const uint32_t hash = Object::hash(key);
+		steps.push_back({ std::move(key), hash, index });
+	}
+
+	void parsePointer(std::string_view path) {
+		for (std::string& key : json_pointer::split(path))
+			addStep(std::move(key));
+	}
+
+	// Names after '.' run up to the next '.' or '[', brackets hold an index or a quoted name.
+	void parseJsonPath(std::string_view path) {
+		const auto invalid = [&]() {
+			return std::invalid_argument("Invalid json path: " + std::string(path));
+		};
+
+		for (size_t i = 1; i < path.length(); ) {
+			if (path[i] == '.') {
+				const size_t end = std::min(path.find_first_of(".[", i + 1), path.length());
+				if (end == i + 1)
+					throw invalid();
+				addStep(std::string(path.substr(i + 1, end - i - 1)));
+				i = end;
+			} else if (path[i] == '[' && i + 1 < path.length() && (path[i + 1] == '\'' || path[i + 1] == '\"')) {
+				const size_t end = path.find(path[i + 1], i + 2);
+				if (end == std::string_view::npos || end + 1 >= path.length() || path[end + 1] != ']')
+					throw invalid();
+				addStep(std::string(path.substr(i + 2, end - i - 2)));
+				i = end + 2;
+			} else if (path[i] == '[') {
+				const size_t end = path.find(']', i + 1);
+				if (end == std::string_view::npos)
+					throw invalid();
+				addStep(std::string(path.substr(i + 1, end - i - 1)));
+				if (steps.back().index == SIZE_MAX)
+					throw invalid();
+				i = end + 1;
+			} else {
+				throw invalid();
+			}
+		}
+	}
+
+	// Returns the child of value selected by s, nullptr if there is none.
+	static const json* follow(const json& value, const step& s) noexcept {
+		if (const Object* const members = value.try_get<Object>()) {
+			const auto it = members->find(s.key, s.hash);
+			return it == members->end() ? nullptr : &it->second;
+		}
+		if (const Array* const elements = value.try_get<Array>())
+			return s.index < elements->size() ? &(*elements)[s.index] : nullptr;
+		return nullptr;
+	}
+
+public:
+	// An empty path refers to the whole document.
+	explicit json_path(std::string_view path) {
+		if (path.empty())
+			return;
+		if (path[0] == '$') {
+			parseJsonPath(path);
+		} else {
+			parsePointer(path);
+		}
+	}
+
+	json_path(const char* path) : json_path(std::string_view(path)) {}
+
+	const json* find(const json& document) const noexcept {
+		const json* value = &document;
+		for (auto it = steps.begin(); it != steps.end() && value != nullptr; it++)
+			value = follow(*value, *it);
+		return value;
+	}
+
+	json* find(json& document) const noexcept {
+		return const_cast<json*>(find(std::as_const(document)));
+	}
+
+	bool exists(const json& document) const noexcept {
+		return find(document) != nullptr;
+	}
+
+	// Throws std::out_of_range if the path does not exist.
+	const json& at(const json& document) const {
+		const json* const value = find(document);
+		if (value == nullptr)
+			throw std::out_of_range("Path does not exist");
+		return *value;
+	}
+};
+
+// Set of json_paths that are looked up together. They are ordered once, so paths
+// with a common prefix are next to each other and every shared step is followed
+// only once for all of them.
+class json_paths {
+private:
+	std::vector<json_path> paths;
+	std::vector<uint32_t> order;
+
+	// The paths of [first, last) share their first depth steps, which lead to value.
+	void find(const json* value, const size_t depth, const uint32_t* first, const uint32_t* const last, const json** results) const noexcept {
+		while (first != last) {
+			const std::vector<json_path::step>& steps = paths[*first].steps;
+			// shorter paths are ordered before the ones they are a prefix of
+			if (steps.size() == depth) {
+				results[*first++] = value;
+				continue;
+			}
+
+			const uint32_t* group = first + 1;
+			while (group != last && paths[*group].steps[depth] == steps[depth])
+				group++;
+
+			const json* const child = value == nullptr ? nullptr : json_path::follow(*value, steps[depth]);
+			find(child, depth + 1, first, group, results);
+			first = group;
+		}
+	}
+
+public:
+	explicit json_paths(std::vector<json_path> paths) : paths(std::move(paths)), order(this->paths.size()) {
+		for (uint32_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [this](const uint32_t a, const uint32_t b) {
+			return this->paths[a].steps < this->paths[b].steps;
+		});
+	}
+
+	json_paths(std::initializer_list<json_path> paths) : json_paths(std::vector<json_path>(paths)) {}
+
+	size_t size() const noexcept {
+		return paths.size();
+	}
+
+	// Stores the value of paths[i], or nullptr if it does not exist, in results[i].
+	// Throws std::length_error if results has fewer elements than there are paths.
+	void find(const json& document, std::span<const json*> results) const {
+		if (results.size() < paths.size())
+			throw std::length_error("Too few results for json_paths");
+		find(&document, 0, order.data(), order.data() + order.size(), results.data());
+	}
+
+	std::vector<const json*> find(const json& document) const {
+		std::vector<const json*> results(paths.size());
+		find(document, results);
+		return results;
+	}
+};
+
+std::ostream& operator<<(std::ostream& os, const json& json) {
+	json.to_string(os, 0);
+	return os;
+}
@@ -0,0 +1,713 @@
+// Checks of every parser, the serializer and the other entry points of json.hpp, built like benchmark.cpp:
+//   g++ -std=c++20 -O2 test.cpp -o test && ./test
+// Exits with 1 and prints the first failed checks if anything is wrong.
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <optional>
+#include "json.hpp"
+
+static size_t failures = 0;
+
+static void check(const bool condition, const std::string& what) {
+	if (!condition) {
+		if (++failures <= 20)
+			std::cout << "FAILED: " << what << std::endl;
+	}
+}
+
+template<typename F>
+static bool throws(F&& f) {
+	try {
+		f();
+	} catch (const std::exception&) {
+		return true;
+	}
+	return false;
+}
+
+static bool same(const json& a, const json& b) {
+	if (a.getType() != b.getType())
+		return false;
+
+	switch (a.getType()) {
+		using enum json::json_type;
+		case null:				return true;
+		case boolean:			return *a.try_get<Boolean>() == *b.try_get<Boolean>();
+		case number:			return std::bit_cast<uint64_t>(*a.try_get<Number>()) == std::bit_cast<uint64_t>(*b.try_get<Number>());
+		case integer:			return *a.try_get<Integer>() == *b.try_get<Integer>();
+		case unsigned_integer:	return *a.try_get<Unsigned>() == *b.try_get<Unsigned>();
+		case string:			return *a.try_get<String>() == *b.try_get<String>();
+		case array: {
+			const Array& x = *a.try_get<Array>();
+			const Array& y = *b.try_get<Array>();
+			if (x.size() != y.size())
+				return false;
+			for (size_t i = 0; i < x.size(); i++) {
+				if (!same(x[i], y[i]))
+					return false;
+			}
+			return true;
+		}
+		case object: {
+			const Object& x = *a.try_get<Object>();
+			const Object& y = *b.try_get<Object>();
+			if (x.size() != y.size())
+				return false;
+			for (auto it = x.begin(), other = y.begin(); it != x.end(); it++, other++) {
+				if (it->first != other->first || !same(it->second, other->second))
+					return false;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+// json_tape has no member iteration, so objects are compared by looking up every key of a.
+// The tape keeps duplicate keys, lookups return the first one like json does.
+static bool same(const json& a, const json_tape::value b) {
+	if (a.getType() != b.getType())
+		return false;
+
+	switch (a.getType()) {
+		using enum json::json_type;
+		case null:				return true;
+		case boolean:			return *a.try_get<Boolean>() == (Boolean)b;
+		case number:			return std::bit_cast<uint64_t>(*a.try_get<Number>()) == std::bit_cast<uint64_t>((Number)b);
+		case integer:			return *a.try_get<Integer>() == (Integer)b;
+		case unsigned_integer:	return *a.try_get<Unsigned>() == (Unsigned)b;
+		case string:			return *a.try_get<String>() == (std::string_view)b;
+		case array: {
+			const Array& x = *a.try_get<Array>();
+			if (x.size() != b.size())
+				return false;
+			for (size_t i = 0; i < x.size(); i++) {
+				if (!same(x[i], b[i]))
+					return false;
+			}
+			return true;
+		}
+		case object: {
+			const Object& x = *a.try_get<Object>();
+			if (x.size() > b.size())
+				return false;
+			for (const auto& [key, value] : x) {
+				if (!same(value, b[std::string_view(key)]))
+					return false;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+// json_cursor is compared the same way, every access walks the text again.
+static bool same(const json& a, const json_cursor b) {
+	if (a.getType() != b.getType())
+		return false;
+
+	switch (a.getType()) {
+		using enum json::json_type;
+		case null:				return true;
+		case boolean:			return *a.try_get<Boolean>() == (Boolean)b;
+		case number:			return std::bit_cast<uint64_t>(*a.try_get<Number>()) == std::bit_cast<uint64_t>((Number)b);
+		case integer:			return *a.try_get<Integer>() == (Integer)b;
+		case unsigned_integer:	return *a.try_get<Unsigned>() == (Unsigned)b;
+		case string:			return *a.try_get<String>() == (std::string)b;
+		case array: {
+			const Array& x = *a.try_get<Array>();
+			if (x.size() != b.size())
+				return false;
+			for (size_t i = 0; i < x.size(); i++) {
+				if (!same(x[i], b[i]))
+					return false;
+			}
+			return true;
+		}
+		case object: {
+			const Object& x = *a.try_get<Object>();
+			if (x.size() > b.size())
+				return false;
+			for (const auto& [key, value] : x) {
+				if (!same(value, b[std::string_view(key)]))
+					return false;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+//----------------------[ generation ]---------------------//
+
+static std::mt19937_64 rng(20221013);
+
+static size_t below(const size_t n) {
+	return std::uniform_int_distribution<size_t>(0, n - 1)(rng);
+}
+
+static double randomDouble() {
+	while (true) {
+		const double d = std::bit_cast<double>(rng());
+		if (std::isfinite(d))
+			return d;
+	}
+}
+
+static std::string randomString() {
+	static const char* const pieces[] = { "a", "key", " ", "\"", "\\", "/", "\n", "\t", "\x01", "\x1f", "\x7f", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80" };
+	std::string s;
+	const size_t length = below(4) == 0 ? below(64) : below(8);
+	for (size_t i = 0; i < length; i++)
+		s += pieces[below(std::size(pieces))];
+	return s;
+}
+
+static json randomValue(const int depth) {
+	switch (below(depth > 3 ? 6 : 8)) {
+		case 0:	return json();
+		case 1:	return json(below(2) == 0);
+		case 2:	return json((Integer)rng() >> below(64));
+		case 3:	return below(8) == 0 ? json((Unsigned)rng() | (Unsigned(1) << 63)) : json((Number)(Integer)(rng() >> 40) / 64);
+		case 4:	return json(randomDouble());
+		case 5:	return json(String(randomString()));
+		case 6: {
+			Array elements;
+			for (size_t i = below(12); i > 0; i--)
+				elements.push_back(randomValue(depth + 1));
+			return json(std::move(elements));
+		}
+		default: {
+			// up to 20 members, so the slot table of Object is used as well
+			Object members;
+			for (size_t i = below(21); i > 0; i--)
+				members.try_emplace(String(randomString() + std::to_string(below(1000))), randomValue(depth + 1));
+			return json(std::move(members));
+		}
+	}
+}
+
+static json randomDocument() {
+	json value = randomValue(0);
+	while (value.getType() != json::json_type::array && value.getType() != json::json_type::object)
+		value = randomValue(0);
+	return value;
+}
+
+//----------------------[ parsers ]---------------------//
+
+struct ignoreEvents {};
+
+// Parses txt with every parser that validates and reports whether they all
+// agree with parse on accepting it and on the resulting values.
+static void checkParsers(const std::string& txt) {
+	std::optional<json> expected;
+	try {
+		expected = json::parse(txt);
+	} catch (const std::exception&) {}
+
+	const auto agrees = [&](const char* name, auto&& parse) {
+		std::optional<json> result;
+		try {
+			result = parse();
+		} catch (const std::exception&) {}
+		check(expected.has_value() == result.has_value() && (!expected || same(*expected, *result)), std::string(name) + " differs from parse on " + txt);
+	};
+
+	agrees("parse_fast", [&]() { return json::parse_fast(txt); });
+	agrees("parse_parallel", [&]() { return json::parse_parallel(txt, 4); });
+	agrees("json_arena", [&]() {
+		json_arena arena;
+		return json(arena.parse(txt));
+	});
+	agrees("json_push_parser", [&]() {
+		json_push_parser parser;
+		for (size_t i = 0; i < txt.length(); i += 7) {
+			if (parser.feed(std::span<const char>(txt.data() + i, std::min<size_t>(7, txt.length() - i))) == json_push_parser::status::value_complete)
+				return parser.take();
+		}
+		throw std::runtime_error("incomplete");
+	});
+
+	// try_parse reports errors by its result, so anything it throws is a failure
+	std::optional<json> tried;
+	bool thrown = false;
+	try {
+		json value;
+		if (!json::try_parse(txt, value))
+			tried = std::move(value);
+	} catch (...) {
+		thrown = true;
+	}
+	check(!thrown && expected.has_value() == tried.has_value() && (!expected || same(*expected, *tried)), "try_parse differs from parse on " + txt);
+
+	bool eventsAccepted = true;
+	try {
+		json::parse_events(txt, ignoreEvents{});
+	} catch (const std::exception&) {
+		eventsAccepted = false;
+	}
+	check(expected.has_value() == eventsAccepted, "parse_events differs from parse on " + txt);
+
+	bool tapeAgrees = !expected.has_value();
+	try {
+		const json_tape tape = json_tape::parse(txt);
+		tapeAgrees = expected.has_value() && same(*expected, tape.root());
+	} catch (const std::exception&) {}
+	check(tapeAgrees, "json_tape differs from parse on " + txt);
+}
+
+//----------------------[ tests ]---------------------//
+
+static void testDocuments() {
+	const char* const documents[] = {
+		"[]", "{}", " \t\r\n[ ]", "[null,true,false]", "[0,-0,1,-1,0.5,-0.5e-3,1E+2]",
+		"[9223372036854775807,-9223372036854775808,9223372036854775808,18446744073709551615,18446744073709551616]",
+		"[1e-400,-1e-400,4.9e-324,1.7976931348623157e308]",
+		R"(["", "\"\\\/\b\f\n\r\t", "\u0041\u00e9\u20ac\ud83d\ude00"])",
+		R"({"a":1,"a":2})",
+		R"({"k0":0,"k1":1,"k2":2,"k3":3,"k4":4,"k5":5,"k6":6,"k7":7,"k8":8,"k9":9,"k3":33})",
+		R"([[[[[[[[[[{"deep":[[[]]]}]]]]]]]]]])",
+		"[", "]", "{", "[1,]", "[,1]", "{\"a\"}", "{\"a\":}", "{\"a\":1,}", "{1:2}", "[01]", "[1.]", "[.5]", "[1e]", "[-]",
+		"[1e400]", "[tru]", "[nul]", "[\"a]", "[\"\\x\"]", "[\"\\u12\"]", "[\"a\nb\"]", "x{}", "[] x", "[1 2]", "",
+	};
+	for (const char* const txt : documents)
+		checkParsers(txt);
+}
+
+static void testRoundTrips() {
+	for (int i = 0; i < 2000; i++) {
+		const json value = randomDocument();
+		for (const int indent : { -1, 0, 2 }) {
+			const std::string txt = value.dump(indent);
+			json parsed;
+			try {
+				parsed = json::parse(txt);
+			} catch (const std::exception& e) {
+				check(false, std::string("parse rejects dump output (") + e.what() + "): " + txt);
+				continue;
+			}
+			check(same(value, parsed), "dump does not round trip: " + txt);
+			checkParsers(txt);
+		}
+	}
+}
+
+// Valid documents with single bytes replaced, inserted, removed or cut off.
+static void testMutations() {
+	static const char replacements[] = "{}[],:\"\\ 0123456789-+.eEtrufalsn\x01\x7f\xff";
+	for (int i = 0; i < 20000; i++) {
+		std::string txt = randomDocument().dump(below(2) == 0 ? -1 : 1);
+		const size_t position = below(txt.length());
+		switch (below(4)) {
+			case 0:	txt[position] = replacements[below(sizeof(replacements) - 1)]; break;
+			case 1:	txt.insert(txt.begin() + position, replacements[below(sizeof(replacements) - 1)]); break;
+			case 2:	txt.erase(position, 1); break;
+			default: txt.resize(position); break;
+		}
+		checkParsers(txt);
+	}
+}
+
+static void testDoubles() {
+	std::string txt;
+	for (int block = 0; block < 100; block++) {
+		Array numbers;
+		// every tenth one is integral, those have to stay Number as well
+		for (int i = 0; i < 10000; i++)
+			numbers.push_back(json(i % 10 == 0 ? std::trunc(randomDouble() / std::exp2(below(1100))) : randomDouble()));
+		const json value(std::move(numbers));
+
+		txt.clear();
+		value.dump(txt);
+		const json parsed = json::parse(txt);
+		const Array& original = *value.try_get<Array>();
+		for (size_t i = 0; i < original.size(); i++) {
+			const Number* const read = parsed[i].try_get<Number>();
+			check(read != nullptr && std::bit_cast<uint64_t>(*read) == std::bit_cast<uint64_t>(*original[i].try_get<Number>()), "double does not round trip: " + original[i].dump());
+		}
+	}
+}
+
+// Every byte value in a string and in a key has to come back unchanged.
+static void testBytes() {
+	std::string bytes;
+	for (int c = 0; c < 256; c++)
+		bytes += (char)c;
+
+	Object members;
+	members.try_emplace(String(bytes), json(String(bytes)));
+	const json value(std::move(members));
+	const std::string txt = value.dump();
+	const json parsed = json::parse(txt);
+	check(same(value, parsed), "bytes do not round trip: " + txt);
+	check(json::write(std::vector<std::string>{ bytes }) == json(Array{ json(String(bytes)) }).dump(), "json::write escapes strings unlike dump");
+	checkParsers(txt);
+}
+
+static void testStrings() {
+	const json literal("abc");
+	const json view(std::string_view("abc"));
+	const json copy(std::string("abc"));
+	check(literal.dump() == "\"abc\"" && view.dump() == literal.dump() && copy.dump() == literal.dump(), "strings are not constructed alike");
+}
+
+// Objects keep their first member, above 8 members they are looked up through the slot table.
+static void testObjects() {
+	std::string txt = "{";
+	for (int i = 0; i < 40; i++)
+		txt += "\"key" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+	txt += "\"key5\":-1}";
+
+	const json value = json::parse(txt);
+	const Object& members = *value.try_get<Object>();
+	check(members.size() == 40, "duplicate key is not merged");
+	for (int i = 0; i < 40; i++) {
+		const std::string key = "key" + std::to_string(i);
+		const auto member = members.find(key);
+		check(member != members.end() && *member->second.try_get<Integer>() == i, "key not found: " + key);
+	}
+	checkParsers(txt);
+}
+
+// Nesting beyond json::maxDepth is an error instead of a stack overflow.
+static void testDepth() {
+	const std::string deepest = std::string(json::maxDepth, '[') + std::string(json::maxDepth, ']');
+	const std::string deeper = std::string(json::maxDepth + 1, '[') + std::string(json::maxDepth + 1, ']');
+	json value;
+	check(!json::try_parse(deepest, value), "try_parse rejects json::maxDepth nested arrays");
+	check(json::try_parse(deeper, value).code == json_errc::depth_exceeded, "try_parse accepts arrays nested deeper than json::maxDepth");
+	check(json::try_parse(std::string(1000000, '['), value).code == json_errc::depth_exceeded, "try_parse does not limit the depth of unterminated arrays");
+
+	std::string objects;
+	for (int i = 0; i < 200000; i++)
+		objects += "{\"a\":";
+	std::string message;
+	try {
+		json::parse(objects);
+	} catch (const std::exception& e) {
+		message = e.what();
+	}
+	check(message.starts_with("Maximum nesting depth exceeded"), "parse does not limit the depth of nested objects");
+}
+
+// Keys parsed with a json_keys table point into it, and tables do not share interned keys.
+static void testKeys() {
+	const std::string txt = R"([{"a_key_longer_than_inline": 1, "": 2}, {"a_key_longer_than_inline": 3, "esc\u0061ped": 4}])";
+	for (int round = 0; round < 2; round++) {
+		json_keys keys;
+		const json value = json::parse(txt, keys);
+		const json fast = json::parse_fast(txt, keys);
+		const std::string_view interned = keys.intern("a_key_longer_than_inline");
+		check(keys.size() == 3 && keys.intern("escaped").data() == keys.intern(std::string("escaped")).data(), "json_keys does not intern every key once");
+		for (const json* const document : { &value, &fast }) {
+			for (const json& element : *document->try_get<Array>()) {
+				const String& key = element.try_get<Object>()->begin()->first;
+				check(key.is_shared() && key.data() == interned.data(), "parsed key does not point into json_keys");
+			}
+		}
+		check(same(value, json::parse(txt)) && same(fast, value), "json_keys changes the parsed document");
+	}
+}
+
+static void testCursor() {
+	for (int i = 0; i < 200; i++) {
+		const json value = randomDocument();
+		const std::string txt = value.dump(i % 2 == 0 ? -1 : 0);
+		const json_cursor cursor(txt);
+		check(same(value, cursor), "json_cursor differs from parse on " + txt);
+		check(same(value, cursor.materialize()), "json_cursor::materialize differs from parse on " + txt);
+	}
+
+	const std::string txt = R"({"a": [1, {"b": "c"}], "esc\u0061ped": true})";
+	const json_cursor cursor(txt);
+	check((std::string)cursor["a"][1]["b"] == "c" && (Boolean)cursor["escaped"], "json_cursor does not follow keys and indices");
+
+	check(throws([&]() { cursor[size_t(0)]; }), "json_cursor indexes an object by position");
+	check(throws([&]() { cursor["a"][2]; }), "json_cursor accepts an array index out of range");
+	check(throws([&]() { cursor["missing"]; }), "json_cursor finds a missing key");
+	check(throws([&]() { (Integer)cursor["a"]; }), "json_cursor converts an array to Integer");
+}
+
+// Random path to a value of document as json pointer tokens, returns that value.
+static const json& randomPath(const json& document, std::vector<std::string>& tokens) {
+	const json* value = &document;
+	while (below(4) != 0) {
+		if (const Object* const members = value->try_get<Object>(); members != nullptr && !members->empty()) {
+			auto it = members->begin();
+			std::advance(it, below(members->size()));
+			tokens.emplace_back(it->first);
+			value = &it->second;
+		} else if (const Array* const elements = value->try_get<Array>(); elements != nullptr && !elements->empty()) {
+			const size_t index = below(elements->size());
+			tokens.push_back(std::to_string(index));
+			value = &(*elements)[index];
+		} else {
+			break;
+		}
+	}
+	return *value;
+}
+
+static std::string toPointer(const std::vector<std::string>& tokens) {
+	std::string pointer;
+	for (const std::string& token : tokens) {
+		pointer += '/';
+		for (const char c : token)
+			pointer += c == '~' ? "~0" : c == '/' ? "~1" : std::string(1, c);
+	}
+	return pointer;
+}
+
+// Selected values are kept whole at the same pointer, everything else is dropped
+// or null, and the result is the same whichever way the text was written.
+static void testProjection() {
+	const std::string txt = R"({"a/b": {"~x": [1, 20, 3], "y": 2}, "c": [{"id": 1, "n": "x"}, {"id": 2}], "z": "s"})";
+	const auto projects = [&](std::initializer_list<std::string_view> pointers, const std::string& expected) {
+		const json result = json::parse(txt, json_projection(pointers));
+		check(same(json::parse(expected), result), "json_projection selects " + result.dump() + " instead of " + expected);
+	};
+	projects({ "/a~1b/~0x/1" }, R"({"a/b": {"~x": [null, 20]}})");
+	projects({ "/c/*/id" }, R"({"c": [{"id": 1}, {"id": 2}]})");
+	projects({ "/*/y" }, R"({"a/b": {"y": 2}, "c": []})");
+	projects({ "/z", "/a~1b/y" }, R"({"a/b": {"y": 2}, "z": "s"})");
+	projects({ "/c/1", "/c" }, R"({"c": [{"id": 1, "n": "x"}, {"id": 2}]})");
+	projects({ "/missing" }, "{}");
+	projects({ "" }, txt);
+
+	check(throws([]() { json_projection{ "a" }; }), "json_projection accepts a pointer without '/'");
+	check(throws([]() { json_projection{ "/~2" }; }), "json_projection accepts an invalid escape");
+
+	for (int i = 0; i < 500; i++) {
+		const json value = randomDocument();
+		std::vector<std::string> tokens;
+		const json& selected = randomPath(value, tokens);
+		const json_projection projection{ toPointer(tokens) };
+
+		const json result = json::parse(value.dump(i % 2 == 0 ? -1 : 0), projection);
+		const json* found = &result;
+		for (const std::string& token : tokens) {
+			if (const Object* const members = found->try_get<Object>()) {
+				const auto it = members->find(token);
+				found = it == members->end() ? nullptr : &it->second;
+			} else {
+				const Array* const elements = found->try_get<Array>();
+				const size_t index = std::stoul(token);
+				found = elements != nullptr && index < elements->size() ? &(*elements)[index] : nullptr;
+			}
+			if (found == nullptr)
+				break;
+		}
+		check(found != nullptr && same(selected, *found), "json_projection loses " + toPointer(tokens) + " of " + value.dump());
+	}
+}
+
+// Paths have to lead to the same value as walking the document by hand, in both
+// notations, alone and in json_paths.
+static void testPaths() {
+	const json document = json::parse(R"({"a": {"b": [0, 1, 2, {"c": "d", "": 5}], "e/f": true, "0": null}})");
+	const json& c = document["a"]["b"][3]["c"];
+	check(json_path("/a/b/3/c").find(document) == &c && json_path("$.a['b'][3].c").find(document) == &c, "json_path does not find /a/b/3/c");
+	check(json_path("$['a'][\"e/f\"]").find(document) == json_path("/a/e~1f").find(document) && json_path("/a/e~1f").exists(document), "json_path does not unescape keys");
+	check(json_path("/a/b/3/").find(document) == &document["a"]["b"][3][""], "json_path does not find empty keys");
+	check(json_path("/a/0").exists(document) && !json_path("/a/b/00").exists(document), "json_path does not tell keys from indices");
+	check(json_path("").find(document) == &document && json_path("$").find(document) == &document, "json_path without steps is not the document");
+	check(!json_path("/a/b/4").exists(document) && !json_path("/a/b/3/c/d").exists(document) && !json_path("/x").exists(document), "json_path finds values that do not exist");
+	check(throws([&]() { json_path("/a/x").at(document); }), "json_path::at does not throw on a missing path");
+	for (const char* const invalid : { "a", "/~", "$.", "$a", "$[x]", "$[1", "$['a'", "$['a'x" })
+		check(throws([&]() { json_path{ invalid }; }), std::string("json_path accepts ") + invalid);
+
+	for (int i = 0; i < 200; i++) {
+		const json value = randomDocument();
+
+		std::vector<json_path> paths;
+		std::vector<const json*> expected;
+		for (size_t j = below(20); j > 0; j--) {
+			std::vector<std::string> tokens;
+			const json& selected = randomPath(value, tokens);
+
+			// the same path in JSONPath notation, keys of objects quoted and indices of arrays not
+			std::string jsonPath = "$";
+			const json* walk = &value;
+			for (const std::string& token : tokens) {
+				if (const Array* const elements = walk->try_get<Array>()) {
+					jsonPath += "[" + token + "]";
+					walk = &(*elements)[std::stoul(token)];
+				} else {
+					jsonPath += "['" + token + "']";
+					walk = &walk->try_get<Object>()->find(token)->second;
+				}
+			}
+
+			// a quoted name never selects an array element
+			const bool missing = below(4) == 0;
+			if (missing) {
+				tokens.push_back("missing");
+				jsonPath += "['missing']";
+			}
+
+			const json* const target = missing ? nullptr : &selected;
+			check(json_path(toPointer(tokens)).find(value) == target, "json_path differs from the document on " + toPointer(tokens));
+			check(json_path(jsonPath).find(value) == target, "json_path differs from the document on " + jsonPath);
+			paths.emplace_back(toPointer(tokens));
+			expected.push_back(target);
+		}
+
+		const json_paths batch(paths);
+		check(batch.size() == paths.size() && batch.find(value) == expected, "json_paths differs from json_path");
+	}
+
+	const json_paths batch{ "/a/b/0", "/a", "/a/b/1", "/x/y", "/a/b/0" };
+	const std::vector<const json*> results = batch.find(document);
+	check(results == std::vector<const json*>{ &document["a"]["b"][size_t(0)], &document["a"], &document["a"]["b"][1], nullptr, &document["a"]["b"][size_t(0)] }, "json_paths does not keep the order of its paths");
+
+	std::vector<const json*> tooFew(batch.size() - 1);
+	check(throws([&]() { batch.find(document, tooFew); }), "json_paths writes past the end of its results");
+}
+
+// Files are written out and read back, mapped or not depending on the platform.
+static void testFiles() {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / ("json_test_" + std::to_string(rng()) + ".json");
+	const auto write = [&](const std::string& txt) {
+		std::ofstream(path, std::ios::binary) << txt;
+	};
+
+	for (int i = 0; i < 20; i++) {
+		const json value = randomDocument();
+		const std::string txt = value.dump(i % 2 == 0 ? -1 : 0);
+		write(txt);
+
+		const json_file file(path.string());
+		check(file.view() == txt, "json_file does not read the whole file");
+		check(same(value, json::parse_file(path.string())), "parse_file differs from parse on " + txt);
+		check(same(value, json_cursor(file.view())), "json_cursor over json_file differs from parse on " + txt);
+
+		json_file original(path.string());
+		const json_file moved = std::move(original);
+		check(moved.view() == txt, "json_file loses its contents when moved");
+	}
+
+	write("");
+	check(json_file(path.string()).view().empty(), "json_file of an empty file is not empty");
+	check(throws([&]() { json::parse_file(path.string()); }), "parse_file accepts an empty file");
+
+	std::filesystem::remove(path);
+	check(throws([&]() { json_file file(path.string()); }), "json_file opens a missing file");
+}
+
+// Lines in input order, blank ones skipped, with enough of them for several batches.
+static void testLines() {
+	std::vector<json> values;
+	std::string txt;
+	for (int i = 0; i < 3000; i++) {
+		values.push_back(randomDocument());
+		txt += values.back().dump();
+		txt += i % 7 == 0 ? "\r\n\n  \n" : "\n";
+	}
+
+	for (const unsigned threads : { 1u, 4u }) {
+		const std::vector<json> parsed = json::parse_lines(txt, threads);
+		bool equal = parsed.size() == values.size();
+		for (size_t i = 0; equal && i < parsed.size(); i++)
+			equal = same(values[i], parsed[i]);
+		check(equal, "parse_lines differs from the documents it was given");
+
+		size_t next = 0;
+		json::parse_lines(txt, [&](json&& value) {
+			check(next < values.size() && same(values[next], value), "parse_lines calls back out of order");
+			next++;
+		}, threads);
+		check(next == values.size(), "parse_lines does not call back for every line");
+	}
+
+	std::string message;
+	try {
+		json::parse_lines("[1]\n\n{\"a\":}\n[2]\n");
+	} catch (const std::exception& e) {
+		message = e.what();
+	}
+	check(message.starts_with("Invalid json in line 3"), "parse_lines does not report the invalid line: " + message);
+}
+
+// Many values in one chunk, taken one after the other.
+static void testPushParser() {
+	std::string txt;
+	for (int i = 0; i < 10000; i++)
+		txt += "{\"id\": " + std::to_string(i) + "}\n";
+
+	json_push_parser parser;
+	Integer expected = 0;
+	for (auto status = parser.feed(txt); status == json_push_parser::status::value_complete; status = parser.feed({})) {
+		const json value = parser.take();
+		check(*value["id"].try_get<Integer>() == expected++, "json_push_parser takes values out of order");
+	}
+	check(expected == 10000 && parser.buffered() == 1, "json_push_parser does not take all values of a chunk");
+}
+
+struct numbers {
+	uint64_t id;
+	int8_t small;
+	std::optional<double> ratio;
+};
+
+template<>
+struct json_fields<numbers> {
+	static constexpr auto members = std::make_tuple(json_field("id", &numbers::id), json_field("small", &numbers::small), json_field("ratio", &numbers::ratio));
+};
+
+static void testBinding() {
+	const numbers written{ 18446744073709551615u, -128, 0.1 };
+	const numbers read = json::parse_as<numbers>(json::write(written));
+	check(read.id == written.id && read.small == written.small && read.ratio == written.ratio, "bound struct does not round trip: " + json::write(written));
+
+	for (const char* const txt : { R"({"small": 128})", R"({"id": -1})", R"({"id": 1.5})", R"({"id": 18446744073709551616})" }) {
+		bool thrown = false;
+		try {
+			json::parse_as<numbers>(txt);
+		} catch (const std::exception&) {
+			thrown = true;
+		}
+		check(thrown, std::string("parse_as accepts ") + txt);
+	}
+}
+
+static void testTape() {
+	const json_tape tape = json_tape::parse(R"({"a":10,"b":20})");
+	bool thrown = false;
+	try {
+		(void)tape.root()[size_t(0)];
+	} catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	check(thrown, "json_tape indexes an object by position");
+}
+
+int main() {
+	testDocuments();
+	testObjects();
+	testBytes();
+	testStrings();
+	testBinding();
+	testTape();
+	testCursor();
+	testFiles();
+	testProjection();
+	testPaths();
+	testKeys();
+	testDepth();
+	testPushParser();
+	testLines();
+	testRoundTrips();
+	testMutations();
+	testDoubles();
+
+	if (failures != 0) {
+		std::cout << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "all checks passed" << std::endl;
+}